@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Geode/loader/Dispatch.hpp>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Verifier lookups for other mods, served from this mod's cache and request
+// registry so that one fetch is shared by every consumer in the process.
+// Every call returns an error if Verifier Labels isn't loaded.
+
+#ifdef MY_MOD_ID
+    #undef MY_MOD_ID
+#endif
+#define MY_MOD_ID "suposed.verifier_labels"
+
+namespace verifier_labels {
+    struct VerifierInfo {
+        int levelID = 0;
+        bool duo = false;
+        // Empty if the level isn't on AREDL/AREPL.
+        std::string verifier;
+        std::string video;
+        bool legacy = false;
+    };
+
+    struct LevelQuery {
+        int levelID = 0;
+        bool duo = false;
+        bool platformer = false;
+    };
+
+    // Cached data only; never touches the network.
+    inline geode::Result<std::optional<VerifierInfo>> tryGet(int levelID, bool duo)
+        GEODE_EVENT_EXPORT(&tryGet, (levelID, duo));
+
+    // Cached data if present, otherwise joins or starts a fetch. The callback
+    // runs on the main thread, possibly before get() returns.
+    inline geode::Result<> get(LevelQuery level, std::function<void(VerifierInfo const&)> callback)
+        GEODE_EVENT_EXPORT(&get, (level, callback));
+
+    // Resolves every level, then calls back once with results in query order.
+    inline geode::Result<> getMany(
+        std::vector<LevelQuery> levels, std::function<void(std::vector<VerifierInfo> const&)> callback
+    ) GEODE_EVENT_EXPORT(&getMany, (levels, callback));
+}
+
+#undef MY_MOD_ID
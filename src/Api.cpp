@@ -0,0 +1,73 @@
+#define GEODE_DEFINE_EVENT_EXPORTS
+#include "../include/VerifierLabels.hpp"
+
+#include "LevelRequests.hpp"
+#include "Settings.hpp"
+#include "VerifierCache.hpp"
+#include "core/LevelKey.hpp"
+
+#include <memory>
+
+using namespace geode::prelude;
+using namespace verifier_labels;
+
+static VerifierInfo toInfo(uint32_t key, VerifierData const& data) {
+    return {levelIDFromKey(key), isDuoKey(key), data.verifier, data.video, data.legacy};
+}
+
+Result<std::optional<VerifierInfo>> verifier_labels::tryGet(int levelID, bool duo) {
+    auto key = packLevelKey(levelID, duo);
+    if (auto cached = findCached(key)) return Ok(toInfo(key, *cached));
+    return Ok(std::nullopt);
+}
+
+// Offline mode promises no traffic the player didn't ask for, so other mods
+// get whatever is saved, however old.
+static VerifierInfo savedInfo(LevelQuery const& level) {
+    auto key = packLevelKey(level.levelID, level.duo);
+    if (auto saved = findCachedAnyAge(key)) return toInfo(key, *saved);
+    return {level.levelID, level.duo};
+}
+
+Result<> verifier_labels::get(LevelQuery level, std::function<void(VerifierInfo const&)> callback) {
+    if (level.levelID <= 0) return Err("invalid level ID");
+    if (settings().offlineMode) {
+        callback(savedInfo(level));
+        return Ok();
+    }
+    resolveLevel(level.platformer, level.levelID, level.duo, [callback](uint32_t key, VerifierData const& data) {
+        callback(toInfo(key, data));
+    });
+    return Ok();
+}
+
+Result<> verifier_labels::getMany(
+    std::vector<LevelQuery> levels, std::function<void(std::vector<VerifierInfo> const&)> callback
+) {
+    if (levels.empty()) {
+        callback({});
+        return Ok();
+    }
+
+    struct Batch {
+        std::vector<VerifierInfo> results;
+        size_t remaining;
+        std::function<void(std::vector<VerifierInfo> const&)> callback;
+    };
+    auto batch = std::make_shared<Batch>(Batch{std::vector<VerifierInfo>(levels.size()), levels.size(), std::move(callback)});
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        auto const& level = levels[i];
+        if (level.levelID <= 0 || settings().offlineMode) {
+            batch->results[i] = level.levelID > 0 ? savedInfo(level) : VerifierInfo{level.levelID, level.duo};
+            if (--batch->remaining == 0) batch->callback(batch->results);
+            continue;
+        }
+        auto onResult = [batch, i](uint32_t key, VerifierData const& data) {
+            batch->results[i] = toInfo(key, data);
+            if (--batch->remaining == 0) batch->callback(batch->results);
+        };
+        resolveLevel(level.platformer, level.levelID, level.duo, onResult, RequestPriority::Background);
+    }
+    return Ok();
+}
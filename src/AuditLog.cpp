@@ -0,0 +1,52 @@
+#include "AuditLog.hpp"
+#include "Common.hpp"
+#include "Settings.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/file.hpp>
+
+#include <algorithm>
+
+using namespace geode::prelude;
+
+static constexpr const char* AUDIT_FILE = "audit.bin";
+static constexpr size_t AUDIT_CAPACITY = 8192;
+
+static AuditRing s_audit(AUDIT_CAPACITY);
+
+void loadAuditLog() {
+    auto path = Mod::get()->getSaveDir() / AUDIT_FILE;
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec) || ec) return;
+    auto res = file::readBinary(path);
+    if (!res) return;
+    if (auto ring = AuditRing::deserialize(res.unwrap(), AUDIT_CAPACITY)) {
+        s_audit = std::move(*ring);
+    }
+    else {
+        log::warn("Ignoring invalid {}", AUDIT_FILE);
+    }
+}
+
+void saveAuditLog() {
+    if (!settings().auditLog || s_audit.size() == 0) return;
+    auto path = Mod::get()->getSaveDir() / AUDIT_FILE;
+    if (auto res = file::writeBinary(path, s_audit.serialize()); !res) {
+        log::error("Failed to save {}: {}", AUDIT_FILE, res.unwrapErr());
+    }
+}
+
+void audit(
+    uint32_t key, AuditDecision decision, AuditReason reason, VerifierData const* entry, bool background,
+    AuditOutcome outcome
+) {
+    if (!settings().auditLog) return;
+    auto now = nowSec();
+    uint32_t age = AUDIT_NO_ENTRY;
+    if (entry) age = static_cast<uint32_t>(std::clamp<long long>(now - entry->timestamp, 0, AUDIT_NO_ENTRY - 1));
+    s_audit.push({static_cast<uint32_t>(now), key, age, decision, reason, background, outcome});
+}
+
+$on_mod(DataSaved) {
+    saveAuditLog();
+}
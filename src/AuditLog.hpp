@@ -0,0 +1,19 @@
+#pragma once
+
+#include "core/AuditLog.hpp"
+#include "core/VerifierData.hpp"
+
+#include <cstdint>
+
+// With the audit-log setting on, every request decision is kept in a ring of
+// AUDIT_CAPACITY records, saved to audit.bin with the rest of the mod's data.
+// tools/auditdump reads it back.
+
+void loadAuditLog();
+void saveAuditLog();
+
+// `entry` is whatever was cached for the key, valid or not.
+void audit(
+    uint32_t key, AuditDecision decision, AuditReason reason, VerifierData const* entry, bool background,
+    AuditOutcome outcome = AuditOutcome::Pending
+);
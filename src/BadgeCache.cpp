@@ -0,0 +1,84 @@
+#include "BadgeCache.hpp"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <list>
+#include <unordered_map>
+
+using namespace geode::prelude;
+
+static constexpr size_t BADGE_CACHE_BUDGET = 4 * 1024 * 1024;
+
+struct BadgeEntry {
+    std::string key;
+    CCTexture2D* texture;
+    size_t bytes;
+};
+
+static std::list<BadgeEntry> s_badges; // most recently used first
+static std::unordered_map<std::string, std::list<BadgeEntry>::iterator> s_badgeIndex;
+static size_t s_badgeBytes = 0;
+
+static void evictBadges() {
+    while (s_badgeBytes > BADGE_CACHE_BUDGET && s_badges.size() > 1) {
+        auto& last = s_badges.back();
+        s_badgeBytes -= last.bytes;
+        // Sprites already showing the badge keep their own reference.
+        last.texture->release();
+        s_badgeIndex.erase(last.key);
+        s_badges.pop_back();
+    }
+}
+
+static CCTexture2D* renderBadge(std::string const& text, const char* font, float scale) {
+    auto label = CCLabelBMFont::create(text.c_str(), font);
+    if (!label) return nullptr;
+    label->setScale(scale);
+    label->setAnchorPoint({0, 0});
+    label->setPosition({0, 0});
+
+    auto size = label->getScaledContentSize();
+    auto rt = CCRenderTexture::create(
+        static_cast<int>(std::ceil(size.width)), static_cast<int>(std::ceil(size.height))
+    );
+    if (!rt) return nullptr;
+
+    rt->begin();
+    label->visit();
+    rt->end();
+    return rt->getSprite()->getTexture();
+}
+
+CCSprite* createBadgeSprite(std::string const& text, const char* font, float scale) {
+    auto key = fmt::format("{}|{}|{}", font, scale, text);
+
+    CCTexture2D* texture = nullptr;
+    if (auto it = s_badgeIndex.find(key); it != s_badgeIndex.end()) {
+        s_badges.splice(s_badges.begin(), s_badges, it->second);
+        texture = it->second->texture;
+    }
+    else {
+        texture = renderBadge(text, font, scale);
+        if (!texture) return nullptr;
+        texture->retain();
+
+        auto bytes = static_cast<size_t>(texture->getPixelsWide()) * texture->getPixelsHigh() * 4;
+        s_badges.push_front({key, texture, bytes});
+        s_badgeIndex[key] = s_badges.begin();
+        s_badgeBytes += bytes;
+        evictBadges();
+    }
+
+    auto sprite = CCSprite::createWithTexture(texture);
+    // Render textures are stored bottom-up.
+    sprite->setFlipY(true);
+    return sprite;
+}
+
+void clearBadgeCache() {
+    for (auto& entry : s_badges) entry.texture->release();
+    s_badges.clear();
+    s_badgeIndex.clear();
+    s_badgeBytes = 0;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+
+// Verifier badges pre-rendered to textures, keyed by (text, font, scale) and
+// evicted least-recently-used once BADGE_CACHE_BUDGET bytes are resident.
+// A badge costs one quad to draw instead of one sprite per glyph.
+cocos2d::CCSprite* createBadgeSprite(std::string const& text, const char* font, float scale);
+void clearBadgeCache();
@@ -0,0 +1,105 @@
+#include "Changelog.hpp"
+#include "Common.hpp"
+#include "JsonBackend.hpp"
+#include "LevelRequests.hpp"
+#include "LevelSets.hpp"
+#include "Metrics.hpp"
+#include "Settings.hpp"
+#include "VerifierCache.hpp"
+#include "core/ChangelogCursor.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/web.hpp>
+
+using namespace geode::prelude;
+
+struct ChangelogFeed {
+    bool platformer;
+    const char* api;
+    const char* cursorKey;
+    const char* lastPollKey;
+    async::TaskHolder<web::WebResponse> task;
+    long long lastAttempt = 0;
+    bool polling = false;
+};
+
+static ChangelogFeed s_feeds[2] = {
+    {false, CLASSIC_CHANGELOG_API, "changelog-cursor-aredl", "changelog-last-poll-aredl"},
+    {true, PLATFORMER_CHANGELOG_API, "changelog-cursor-arepl", "changelog-last-poll-arepl"},
+};
+
+// Entries fetched before this point may predate what the feeds have seen.
+// Kept here as well as in the saved values, since every cache lookup reads it.
+static long long s_trackingSince = 0;
+// Each feed's last successful poll, by platformer.
+static long long s_lastPolls[2] = {};
+
+void loadChangelog() {
+    s_trackingSince = Mod::get()->getSavedValue<int64_t>("changelog-tracking-since", 0);
+    for (auto& feed : s_feeds) {
+        auto& lastPoll = s_lastPolls[feed.platformer];
+        lastPoll = Mod::get()->getSavedValue<int64_t>(feed.lastPollKey, 0);
+        // A clock that went backwards can't vouch for anything.
+        if (lastPoll > nowSec()) lastPoll = 0;
+        feed.lastAttempt = lastPoll;
+    }
+}
+
+static void restartTracking(ChangelogFeed& feed) {
+    log::info("Changelog for {} has a gap, falling back to expiry for older entries", feed.cursorKey);
+    s_trackingSince = nowSec();
+    Mod::get()->setSavedValue<int64_t>("changelog-tracking-since", s_trackingSince);
+}
+
+static void applyFeed(ChangelogFeed& feed, std::vector<ChangelogEntry> const& entries) {
+    auto poll = applyChangelog(Mod::get()->getSavedValue<std::string>(feed.cursorKey), entries);
+    for (int id : poll.changed) {
+        invalidateCached(id);
+        markLevelChanged(feed.platformer, id);
+    }
+    if (poll.gap) restartTracking(feed);
+    if (!poll.changed.empty()) log::debug("Changelog for {} invalidated {} levels", feed.cursorKey, poll.changed.size());
+    Mod::get()->setSavedValue(feed.cursorKey, poll.cursor);
+}
+
+static void pollFeed(ChangelogFeed& feed) {
+    feed.polling = true;
+    feed.lastAttempt = nowSec();
+    auto sentAt = std::chrono::steady_clock::now();
+
+    feed.task.spawn(web::WebRequest().userAgent(USER_AGENT).get(feed.api), [&feed, sentAt](web::WebResponse res) {
+        std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - sentAt;
+        metrics::recordResponse(res.code(), true, res.data().size(), rtt.count());
+        noteNetworkActivity();
+        feed.polling = false;
+        if (!res.ok()) {
+            log::debug("Changelog request for {} failed: {}", feed.cursorKey, res.code());
+            return;
+        }
+        auto entries = reduceChangelog(asJsonText(res.data()));
+        if (!entries) {
+            log::debug("Failed to parse changelog for {}", feed.cursorKey);
+            return;
+        }
+        applyFeed(feed, *entries);
+        s_lastPolls[feed.platformer] = nowSec();
+        Mod::get()->setSavedValue<int64_t>(feed.lastPollKey, s_lastPolls[feed.platformer]);
+    });
+}
+
+void pollChangelogIfDue() {
+    if (settings().disableCache) return;
+    auto now = nowSec();
+    for (auto& feed : s_feeds) {
+        if (feed.polling || now - feed.lastAttempt < CHANGELOG_POLL_INTERVAL) continue;
+        pollFeed(feed);
+    }
+}
+
+long long changelogTrackingSince() {
+    return s_trackingSince;
+}
+
+std::span<long long const> changelogLastPolls() {
+    return s_lastPolls;
+}
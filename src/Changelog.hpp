@@ -0,0 +1,19 @@
+#pragma once
+
+#include <span>
+
+// Polls each list's changelog at most every CHANGELOG_POLL_INTERVAL and
+// invalidates only the cache entries of levels that changed. While the feed is
+// being followed, untouched entries stay valid for up to CHANGELOG_MAX_AGE
+// instead of expiring after CACHE_EXPIRY (see core/ChangelogCursor.hpp).
+
+// Restores the tracking start and the last polls, which vouch for entries
+// for CHANGELOG_TRUST_WINDOW after they happened, even across a restart.
+void loadChangelog();
+void pollChangelogIfDue();
+
+// What isCoveredByChangelog() needs, for the cache's expiry (see
+// core/CacheExpiry.hpp): when tracking started, and each feed's last
+// successful poll.
+long long changelogTrackingSince();
+std::span<long long const> changelogLastPolls();
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "core/CacheExpiry.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+static constexpr const char* CACHE_FILE = "verifier_cache.json";
+static constexpr const char* CLASSIC_API = "https://api.aredl.net/v2/api/aredl/levels";
+static constexpr const char* PLATFORMER_API = "https://api.aredl.net/v2/api/arepl/levels";
+static constexpr const char* CLASSIC_CHANGELOG_API = "https://api.aredl.net/v2/api/aredl/changelog";
+static constexpr const char* PLATFORMER_CHANGELOG_API = "https://api.aredl.net/v2/api/arepl/changelog";
+static constexpr const char* USER_AGENT = "Geode-AREDL-Mod/1.1.0";
+static constexpr long long SNAPSHOT_EXPIRY = 6 * 3600;
+static constexpr size_t SESSION_CACHE_MAX = 256;
+
+inline long long nowSec() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
@@ -0,0 +1,58 @@
+#include "FileIo.hpp"
+#include "core/AsyncIo.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace geode::prelude;
+
+// The mod only writes a handful of files, and one worker keeps them in call
+// order. io_uring isn't an option on any platform the game runs on.
+static constexpr size_t IO_THREADS = 1;
+
+static bool s_pollScheduled = false;
+
+static AsyncIo& fileIo() {
+    // Leaked so the worker is never joined during static destruction.
+    static auto io = makeThreadPoolIo(IO_THREADS).release();
+    return *io;
+}
+
+// A scheduler target that runs finished saves' callbacks and unschedules
+// itself once nothing is in flight.
+class FileIoPoller : public CCObject {
+public:
+    void onFrame(float) {
+        fileIo().poll();
+        if (fileIo().inFlight() == 0) {
+            CCScheduler::get()->unscheduleSelector(schedule_selector(FileIoPoller::onFrame), this);
+            s_pollScheduled = false;
+        }
+    }
+};
+
+void saveFileAsync(std::filesystem::path path, std::vector<uint8_t> bytes, char const* what) {
+    fileIo().replace(std::move(path), std::move(bytes), [what = std::string(what)](IoResult res) {
+        if (!res.ok) log::error("Failed to save {}", what);
+    });
+    fileIo().submit();
+    if (s_pollScheduled) return;
+    // Lives as long as the game does.
+    static auto poller = new FileIoPoller();
+    CCScheduler::get()->scheduleSelector(schedule_selector(FileIoPoller::onFrame), poller, 0.f, false);
+    s_pollScheduled = true;
+}
+
+void flushFileIo() {
+    fileIo().drain();
+}
+
+bool flushFileIoUntil(std::chrono::steady_clock::time_point deadline) {
+    return fileIo().drainUntil(deadline);
+}
+
+$on_mod(DataSaved) {
+    flushFileIo();
+}
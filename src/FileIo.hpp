@@ -0,0 +1,17 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Replaces `path` with `bytes` on the I/O worker (write, fsync, rename), so
+// saves made during gameplay never stall a frame. Saves of one path queued
+// while an earlier one is still running collapse into the newest. Failures
+// are logged under `what`.
+void saveFileAsync(std::filesystem::path path, std::vector<uint8_t> bytes, char const* what);
+// Blocks until every queued save is on disk. Runs when the game saves, so
+// quitting doesn't lose a pending write.
+void flushFileIo();
+// flushFileIo() that gives up at `deadline`. True if nothing is left pending.
+bool flushFileIoUntil(std::chrono::steady_clock::time_point deadline);
@@ -0,0 +1,70 @@
+#include "JsonBackend.hpp"
+#include "SchemaJson.hpp"
+#include "core/LevelKey.hpp"
+
+#include <matjson.hpp>
+
+std::optional<LevelSummary> MatjsonBackend::parseLevel(std::string_view json) {
+    auto parsed = matjson::parse(json);
+    if (!parsed.isOk()) return std::nullopt;
+    auto root = parsed.unwrap();
+    if (!root.isObject()) return std::nullopt;
+
+    LevelSummary summary;
+    summary.legacy = root.contains("legacy") && root["legacy"].asBool().unwrapOr(false);
+
+    if (root.contains("verifications")) {
+        auto arr = root["verifications"];
+        if (arr.isArray()) {
+            for (auto const& v : arr) {
+                if (!v.isObject()) continue;
+                if (summary.video.empty() && v.contains("video_url")) {
+                    summary.video = v["video_url"].asString().unwrapOr("");
+                }
+                if (v.contains("submitted_by")) {
+                    auto sub = v["submitted_by"];
+                    if (!sub.isObject()) continue;
+                    std::string name = sub.contains("global_name")
+                        ? sub["global_name"].asString().unwrapOr("") : "";
+                    if (name.empty()) name = sub.contains("username")
+                        ? sub["username"].asString().unwrapOr("") : "";
+                    addVerifierName(summary, std::move(name));
+                }
+            }
+        }
+    }
+    return summary;
+}
+
+std::optional<std::vector<SnapshotEntry>> MatjsonBackend::parseList(std::string_view json) {
+    auto parsed = matjson::parse(json);
+    if (!parsed.isOk() || !parsed.unwrap().isArray()) return std::nullopt;
+
+    std::vector<SnapshotEntry> entries;
+    for (auto const& level : parsed.unwrap()) {
+        if (!level.isObject() || !level.contains("level_id")) continue;
+        int id = static_cast<int>(level["level_id"].asInt().unwrapOr(0));
+        if (id <= 0) continue;
+
+        bool duo = level.contains("two_player") && level["two_player"].asBool().unwrapOr(false);
+        uint32_t flags = duo ? SNAPSHOT_TWO_PLAYER : 0u;
+        if (level.contains("legacy") && level["legacy"].asBool().unwrapOr(false)) {
+            flags |= SNAPSHOT_LEGACY;
+        }
+        auto position = level.contains("position") ? level["position"].asInt().unwrapOr(0) : 0;
+
+        entries.push_back({packLevelKey(id, duo), {static_cast<uint32_t>(position), flags}});
+    }
+    return entries;
+}
+
+bool MatjsonBackend::parseCache(std::string_view json, CacheEntryFn const& onEntry) {
+    auto parsed = matjson::parse(json);
+    if (!parsed.isOk() || !parsed.unwrap().isObject()) return false;
+    for (auto const& [k, v] : parsed.unwrap()) {
+        if (auto data = schemaFromJson<VerifierData>(v)) {
+            onEntry(k, data.unwrap());
+        }
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/ResponseReducer.hpp"
+#include "core/SimdjsonReducer.hpp"
+
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Parsers for level responses, bulk list responses and the cache file. The
+// backend is picked at compile time with the VERIFIER_JSON_BACKEND CMake
+// option; all of them produce identical results (see verifier-jsonbench).
+
+using CacheEntryFn = std::function<void(std::string_view, VerifierData)>;
+
+// Views a response body or file buffer as JSON text without copying it.
+template <class Bytes>
+std::string_view asJsonText(Bytes const& bytes) {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+// Builds a full matjson document, then reads fields out of it.
+struct MatjsonBackend {
+    static std::optional<LevelSummary> parseLevel(std::string_view json);
+    static std::optional<std::vector<SnapshotEntry>> parseList(std::string_view json);
+    static bool parseCache(std::string_view json, CacheEntryFn const& onEntry);
+};
+
+// Single pass over the raw bytes with JsonReader; no document is built.
+struct StreamingBackend {
+    static std::optional<LevelSummary> parseLevel(std::string_view json) {
+        return reduceLevelResponse(json);
+    }
+    static std::optional<std::vector<SnapshotEntry>> parseList(std::string_view json) {
+        return reduceListResponse(json);
+    }
+    static bool parseCache(std::string_view json, CacheEntryFn const& onEntry) {
+        return reduceCacheFile(json, onEntry);
+    }
+};
+
+#ifdef VERIFIER_HAVE_SIMDJSON
+// simdjson's on-demand parser over a padded copy of the input.
+struct SimdjsonBackend {
+    static std::optional<LevelSummary> parseLevel(std::string_view json) {
+        return simdjsonLevelResponse(json);
+    }
+    static std::optional<std::vector<SnapshotEntry>> parseList(std::string_view json) {
+        return simdjsonListResponse(json);
+    }
+    static bool parseCache(std::string_view json, CacheEntryFn const& onEntry) {
+        return simdjsonCacheFile(json, onEntry);
+    }
+};
+#endif
+
+#ifdef VERIFIER_JSON_MATJSON
+using JsonBackend = MatjsonBackend;
+#elif defined(VERIFIER_JSON_SIMDJSON)
+using JsonBackend = SimdjsonBackend;
+#else
+using JsonBackend = StreamingBackend;
+#endif
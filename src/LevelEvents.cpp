@@ -0,0 +1,75 @@
+#include "LevelEvents.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using namespace geode::prelude;
+
+struct LevelSubscriber {
+    std::vector<uint32_t> keys;
+    std::function<void(uint32_t)> callback;
+    bool active = true;
+};
+
+static std::unordered_map<uint32_t, std::vector<std::shared_ptr<LevelSubscriber>>> s_subscribers;
+static std::vector<uint32_t> s_pendingUpdates;
+
+static void unsubscribe(std::shared_ptr<LevelSubscriber> const& subscriber) {
+    if (!subscriber) return;
+    subscriber->active = false;
+    for (auto key : subscriber->keys) {
+        auto it = s_subscribers.find(key);
+        if (it == s_subscribers.end()) continue;
+        std::erase(it->second, subscriber);
+        if (it->second.empty()) s_subscribers.erase(it);
+    }
+}
+
+static void flushLevelUpdates() {
+    auto keys = std::move(s_pendingUpdates);
+    s_pendingUpdates.clear();
+    std::ranges::sort(keys);
+    auto dupes = std::ranges::unique(keys);
+    keys.erase(dupes.begin(), dupes.end());
+
+    for (auto key : keys) {
+        auto it = s_subscribers.find(key);
+        if (it == s_subscribers.end()) continue;
+        // Callbacks may subscribe or unsubscribe while we dispatch.
+        auto subscribers = it->second;
+        for (auto const& subscriber : subscribers) {
+            if (subscriber->active) subscriber->callback(key);
+        }
+    }
+}
+
+void publishLevelUpdate(uint32_t key) {
+    if (s_pendingUpdates.empty()) {
+        Loader::get()->queueInMainThread(flushLevelUpdates);
+    }
+    s_pendingUpdates.push_back(key);
+}
+
+LevelSubscription& LevelSubscription::operator=(LevelSubscription&& other) noexcept {
+    if (this != &other) {
+        unsubscribe(m_subscriber);
+        m_subscriber = std::move(other.m_subscriber);
+    }
+    return *this;
+}
+
+LevelSubscription::~LevelSubscription() {
+    unsubscribe(m_subscriber);
+}
+
+LevelSubscription subscribeLevels(std::initializer_list<uint32_t> keys, std::function<void(uint32_t)> callback) {
+    auto subscriber = std::make_shared<LevelSubscriber>(LevelSubscriber{keys, std::move(callback)});
+    for (auto key : subscriber->keys) s_subscribers[key].push_back(subscriber);
+
+    LevelSubscription subscription;
+    subscription.m_subscriber = std::move(subscriber);
+    return subscription;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+
+// Cache commits are published by key and delivered once per frame, batched
+// and deduplicated, to whoever subscribed to that key.
+
+void publishLevelUpdate(uint32_t key);
+
+struct LevelSubscriber;
+
+// Unsubscribes when destroyed, so it can live in a node's fields.
+class LevelSubscription {
+public:
+    LevelSubscription() = default;
+    LevelSubscription(LevelSubscription&&) noexcept = default;
+    LevelSubscription& operator=(LevelSubscription&& other) noexcept;
+    ~LevelSubscription();
+
+private:
+    friend LevelSubscription subscribeLevels(std::initializer_list<uint32_t>, std::function<void(uint32_t)>);
+
+    std::shared_ptr<LevelSubscriber> m_subscriber;
+};
+
+// `callback` receives each updated key it subscribed to.
+LevelSubscription subscribeLevels(std::initializer_list<uint32_t> keys, std::function<void(uint32_t)> callback);
@@ -0,0 +1,410 @@
+#include "LevelRequests.hpp"
+#include "AuditLog.hpp"
+#include "Common.hpp"
+#include "JsonBackend.hpp"
+#include "LevelSets.hpp"
+#include "Metrics.hpp"
+#include "VerifierCache.hpp"
+#include "core/ConcurrencyLimit.hpp"
+#include "core/LevelKey.hpp"
+#include "core/RetryBackoff.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/web.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace geode::prelude;
+
+// A rate-limited request is retried (see RetryBackoff.hpp) until it has been
+// sent this many times, then the level is given up on for now.
+static constexpr int MAX_ATTEMPTS = 3;
+// After a failure that says nothing about the level (rate limited for good,
+// a server or network error, an unreadable response) it isn't fetched again
+// for this long. Such failures aren't cached; only a 404 is.
+static constexpr double FAILURE_BACKOFF = 60.0;
+// How long a cellular radio stays in its high-power state after traffic. A
+// request inside this tail costs little; one after it wakes the radio again.
+static constexpr double RADIO_TAIL = 5.0;
+// Longest a background fetch is held waiting for other traffic. Only mobile
+// radios care; desktop sends everything right away.
+#ifdef GEODE_IS_MOBILE
+static constexpr float BATCH_WINDOW = 30.f;
+#else
+static constexpr float BATCH_WINDOW = 0.f;
+#endif
+
+struct PendingRequest {
+    bool platformer = false;
+    int levelID = 0;
+    bool duo = false;
+    bool background = false;
+    int attempts = 0;
+    AuditReason reason = AuditReason::None;
+    async::TaskHolder<web::WebResponse> task;
+    std::vector<LevelCallback> callbacks;
+};
+
+struct RetryWait {
+    uint32_t key;
+    double dueAt; // monotonicSec()
+};
+
+static std::unordered_map<uint32_t, std::unique_ptr<PendingRequest>> s_pending;
+// Keys waiting for a free slot; interactive requests jump to the front.
+static std::deque<uint32_t> s_queue;
+// Background keys held for the next burst, in arrival order.
+static std::deque<uint32_t> s_held;
+static bool s_releaseScheduled = false;
+// Rate-limited keys waiting out their retry delay.
+static std::vector<RetryWait> s_retrying;
+static std::mt19937 s_jitter{std::random_device{}()};
+// When each key's last fetch failed, see FAILURE_BACKOFF.
+static std::unordered_map<uint32_t, double> s_failedAt;
+static double s_lastActivity = -RADIO_TAIL;
+static size_t s_burstRequests = 0;
+static size_t s_inFlight = 0;
+static ConcurrencyLimit s_limit;
+// Completed requests are kept until the next frame, since a task holder can't
+// be destroyed from inside its own callback.
+static std::vector<std::unique_ptr<PendingRequest>> s_finished;
+
+static double monotonicSec() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void retireRequest(std::unique_ptr<PendingRequest> request) {
+    if (s_finished.empty()) {
+        Loader::get()->queueInMainThread([] { s_finished.clear(); });
+    }
+    s_finished.push_back(std::move(request));
+}
+
+static void completeRequest(uint32_t key, bool platformer, VerifierData data, AuditOutcome outcome) {
+    data.platformer = platformer;
+    auto node = s_pending.extract(key);
+    bool background = !node.empty() && node.mapped()->background;
+    audit(key, AuditDecision::Completed, AuditReason::None, findCachedAnyAge(key), background, outcome);
+
+    s_failedAt.erase(key);
+    storeCached(key, data);
+    if (!background) recordAccess(key);
+    scheduleCacheSave();
+
+    if (node.empty()) return;
+    auto request = std::move(node.mapped());
+    for (auto& callback : request->callbacks) callback(key, data);
+    retireRequest(std::move(request));
+}
+
+// What a level with no usable answer is shown as: its expired entry if there
+// is one, else nothing.
+static VerifierData fallbackData(VerifierData const* stale) {
+    return stale ? *stale : VerifierData{"", "", false, nowSec()};
+}
+
+// Leaves the cache alone, since the failure says nothing about the level.
+static void failRequest(uint32_t key, AuditOutcome outcome) {
+    auto node = s_pending.extract(key);
+    bool background = !node.empty() && node.mapped()->background;
+    auto stale = findCachedAnyAge(key);
+    auto data = fallbackData(stale);
+    audit(key, AuditDecision::Completed, AuditReason::None, stale, background, outcome);
+
+    auto now = monotonicSec();
+    std::erase_if(s_failedAt, [now](auto const& failed) { return now - failed.second >= FAILURE_BACKOFF; });
+    s_failedAt[key] = now;
+
+    if (node.empty()) return;
+    auto request = std::move(node.mapped());
+    for (auto& callback : request->callbacks) callback(key, data);
+    retireRequest(std::move(request));
+}
+
+static void dispatchQueued();
+
+static void updateQueueGauges() {
+    metrics::requestQueueDepth.set(static_cast<int64_t>(s_queue.size()));
+    metrics::requestsHeld.set(static_cast<int64_t>(s_held.size()));
+    metrics::requestsInFlight.set(static_cast<int64_t>(s_inFlight));
+    metrics::requestConcurrencyLimit.set(static_cast<int64_t>(s_limit.limit()));
+}
+
+static void onResponse(double sentAt, int code) {
+    --s_inFlight;
+    bool congested = code <= 0 || code == 429 || code >= 500;
+    auto signal = congested ? ConcurrencyLimit::Signal::Congested : ConcurrencyLimit::Signal::Ok;
+    auto before = s_limit.limit();
+    if (s_limit.onSample(sentAt, monotonicSec(), signal)) {
+        log::info(
+            "Request concurrency {} -> {} (HTTP {}, baseline RTT {:.0f} ms)",
+            before, s_limit.limit(), code, s_limit.baselineRtt() * 1000
+        );
+    }
+}
+
+static bool radioAwake() {
+    return s_inFlight > 0 || monotonicSec() - s_lastActivity < RADIO_TAIL;
+}
+
+static void releaseHeld() {
+    if (s_held.empty()) return;
+    log::debug("Releasing {} held background requests", s_held.size());
+    s_queue.insert(s_queue.end(), s_held.begin(), s_held.end());
+    s_held.clear();
+}
+
+// Called for every send and response. Held fetches ride along with whatever
+// woke the radio.
+static void touchRadio() {
+    auto now = monotonicSec();
+    if (now - s_lastActivity >= RADIO_TAIL && s_inFlight == 0) {
+        if (s_burstRequests > 0) metrics::radioBurstRequests.observe(static_cast<double>(s_burstRequests));
+        metrics::radioBursts.add();
+        s_burstRequests = 0;
+    }
+    s_lastActivity = now;
+    releaseHeld();
+}
+
+// A scheduler target that sends held fetches once BATCH_WINDOW has passed
+// without other traffic to join.
+class HeldRequestReleaser : public CCObject {
+public:
+    void onRelease(float) {
+        CCScheduler::get()->unscheduleSelector(schedule_selector(HeldRequestReleaser::onRelease), this);
+        s_releaseScheduled = false;
+        releaseHeld();
+        dispatchQueued();
+    }
+};
+
+static void holdRequest(uint32_t key) {
+    s_held.push_back(key);
+    updateQueueGauges();
+    if (s_releaseScheduled) return;
+    // Lives as long as the game does.
+    static auto releaser = new HeldRequestReleaser();
+    CCScheduler::get()->scheduleSelector(schedule_selector(HeldRequestReleaser::onRelease), releaser, BATCH_WINDOW, false);
+    s_releaseScheduled = true;
+}
+
+// A scheduler target that puts rate-limited requests back in line once their
+// delay is up.
+class RetryReleaser : public CCObject {
+public:
+    void onRetry(float);
+};
+
+static void scheduleRetries() {
+    // Lives as long as the game does.
+    static auto releaser = new RetryReleaser();
+    auto scheduler = CCScheduler::get();
+    scheduler->unscheduleSelector(schedule_selector(RetryReleaser::onRetry), releaser);
+    if (s_retrying.empty()) return;
+    auto next = std::ranges::min(s_retrying, {}, &RetryWait::dueAt).dueAt;
+    auto delay = static_cast<float>(std::max(next - monotonicSec(), 0.0));
+    scheduler->scheduleSelector(schedule_selector(RetryReleaser::onRetry), releaser, delay, false);
+}
+
+// Interactive retries go ahead of background work, as they did the first
+// time; someone may have started waiting on a background one meanwhile.
+void RetryReleaser::onRetry(float) {
+    auto now = monotonicSec();
+    auto due = std::ranges::partition(s_retrying, [now](RetryWait const& wait) { return wait.dueAt > now; });
+    for (auto const& wait : due) {
+        auto it = s_pending.find(wait.key);
+        if (it == s_pending.end()) continue;
+        if (it->second->background) s_queue.push_back(wait.key);
+        else s_queue.push_front(wait.key);
+    }
+    s_retrying.erase(due.begin(), due.end());
+    scheduleRetries();
+    dispatchQueued();
+}
+
+// Puts a rate-limited request back in line after Retry-After or a backoff,
+// instead of caching a miss. The task holder is swapped out since we're still
+// inside its callback.
+static bool requeueRequest(uint32_t key, std::optional<double> retryAfter) {
+    auto it = s_pending.find(key);
+    if (it == s_pending.end() || it->second->attempts >= MAX_ATTEMPTS) return false;
+    auto delay = retryDelay(it->second->attempts, retryAfter, std::uniform_real_distribution<double>()(s_jitter));
+    if (!delay) return false;
+
+    auto& request = *it->second;
+    auto retry = std::make_unique<PendingRequest>();
+    retry->platformer = request.platformer;
+    retry->levelID = request.levelID;
+    retry->duo = request.duo;
+    retry->background = request.background;
+    retry->attempts = request.attempts;
+    retry->reason = AuditReason::Retry;
+    retry->callbacks = std::move(request.callbacks);
+    audit(
+        key, AuditDecision::Requeued, AuditReason::Retry, findCachedAnyAge(key), retry->background,
+        AuditOutcome::RateLimited
+    );
+    retireRequest(std::exchange(it->second, std::move(retry)));
+    s_retrying.push_back({key, monotonicSec() + *delay});
+    scheduleRetries();
+    return true;
+}
+
+static void fetchLevel(uint32_t key, PendingRequest& request) {
+    auto platformer = request.platformer;
+    auto levelID = request.levelID;
+    auto duo = request.duo;
+    auto background = request.background;
+    auto url = std::string(platformer ? PLATFORMER_API : CLASSIC_API) + "/" + formatLevelKey(key);
+    auto sentAt = monotonicSec();
+
+    touchRadio();
+    ++s_burstRequests;
+    ++s_inFlight;
+    ++request.attempts;
+    audit(key, AuditDecision::Dispatched, request.reason, findCachedAnyAge(key), background);
+    request.task.spawn(web::WebRequest().userAgent(USER_AGENT).get(url), [=](web::WebResponse res) {
+        // Before onResponse, so a slow response still counts as in flight.
+        touchRadio();
+        onResponse(sentAt, res.code());
+        metrics::recordResponse(res.code(), background, res.data().size(), monotonicSec() - sentAt);
+
+        if (!res.ok()) {
+            log::debug("API request failed for {}: {}", formatLevelKey(key), res.code());
+            if (res.code() == 429) {
+                std::optional<double> retryAfter;
+                if (auto header = res.header("Retry-After")) retryAfter = parseRetryAfter(*header, nowSec());
+                if (requeueRequest(key, retryAfter)) {
+                    dispatchQueued();
+                    return;
+                }
+            }
+            if (res.code() == 404) {
+                recordLevelResult(platformer, levelID, duo, false, false, false);
+                completeRequest(key, platformer, {"", "", false, nowSec()}, AuditOutcome::NotFound);
+            }
+            else {
+                auto outcome = res.code() == 429 ? AuditOutcome::RateLimited
+                    : res.code() >= 500 ? AuditOutcome::ServerError
+                    : AuditOutcome::Failed;
+                failRequest(key, outcome);
+            }
+            dispatchQueued();
+            return;
+        }
+
+        auto summary = JsonBackend::parseLevel(asJsonText(res.data()));
+        if (!summary) {
+            log::debug("Failed to parse JSON response for {}", formatLevelKey(key));
+            failRequest(key, AuditOutcome::ParseError);
+            dispatchQueued();
+            return;
+        }
+
+        recordLevelResult(platformer, levelID, duo, true, summary->legacy, !summary->video.empty());
+        completeRequest(
+            key, platformer, {summary->display(), std::move(summary->video), summary->legacy, nowSec()},
+            AuditOutcome::Ok
+        );
+        dispatchQueued();
+    });
+}
+
+static void dispatchQueued() {
+    while (s_inFlight < s_limit.limit() && !s_queue.empty()) {
+        auto key = s_queue.front();
+        s_queue.pop_front();
+        if (auto it = s_pending.find(key); it != s_pending.end()) fetchLevel(key, *it->second);
+    }
+    updateQueueGauges();
+}
+
+void resolveLevel(bool platformer, int levelID, bool duo, LevelCallback callback, RequestPriority priority) {
+    auto key = packLevelKey(levelID, duo);
+    bool interactive = priority == RequestPriority::Interactive;
+    if (auto cached = findCached(key)) {
+        audit(key, AuditDecision::CacheHit, AuditReason::None, cached, !interactive);
+        if (interactive) recordAccess(key);
+        if (callback) callback(key, *cached);
+        return;
+    }
+
+    // The entry may be in the part of the cache file not read yet.
+    if (cacheLoading()) {
+        whenCacheLoaded([=] { resolveLevel(platformer, levelID, duo, callback, priority); });
+        return;
+    }
+
+    auto stale = findCachedAnyAge(key);
+    auto reason = stale ? AuditReason::Expired : AuditReason::Miss;
+
+    // The negative entry stays in memory only.
+    if (isKnownUnlisted(platformer, levelID, duo)) {
+        audit(key, AuditDecision::LocalUnlisted, reason, stale, !interactive);
+        VerifierData unlisted{"", "", false, nowSec()};
+        unlisted.platformer = platformer;
+        storeCached(key, unlisted);
+        if (callback) callback(key, unlisted);
+        return;
+    }
+
+    if (auto it = s_failedAt.find(key); it != s_failedAt.end() && !s_pending.contains(key)) {
+        if (monotonicSec() - it->second < FAILURE_BACKOFF) {
+            audit(key, AuditDecision::RecentFailure, reason, stale, !interactive);
+            if (callback) callback(key, fallbackData(stale));
+            return;
+        }
+        s_failedAt.erase(it);
+    }
+
+    auto& request = s_pending[key];
+    if (request) {
+        audit(key, AuditDecision::Joined, reason, stale, !interactive);
+        if (callback) request->callbacks.push_back(std::move(callback));
+        // Someone is now waiting on a queued background fetch.
+        if (interactive) {
+            request->background = false;
+            if (auto it = std::ranges::find(s_held, key); it != s_held.end()) {
+                s_held.erase(it);
+                s_queue.push_front(key);
+                dispatchQueued();
+            }
+            else if (auto it = std::ranges::find(s_queue, key); it != s_queue.end()) {
+                s_queue.erase(it);
+                s_queue.push_front(key);
+            }
+        }
+        return;
+    }
+
+    request = std::make_unique<PendingRequest>();
+    request->platformer = platformer;
+    request->levelID = levelID;
+    request->duo = duo;
+    request->background = !interactive;
+    request->reason = reason;
+    audit(key, AuditDecision::Queued, reason, stale, !interactive);
+    if (callback) request->callbacks.push_back(std::move(callback));
+    if (!interactive && BATCH_WINDOW > 0 && !radioAwake()) {
+        holdRequest(key);
+        return;
+    }
+    if (interactive) s_queue.push_front(key);
+    else s_queue.push_back(key);
+    dispatchQueued();
+}
+
+void noteNetworkActivity() {
+    touchRadio();
+    dispatchQueued();
+}
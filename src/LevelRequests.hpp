@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/VerifierData.hpp"
+
+#include <cstdint>
+#include <functional>
+
+// The one place level data is requested from. Concurrent requests for the
+// same key share a single fetch, so every layer and API consumer in the
+// process is served by it.
+
+using LevelCallback = std::function<void(uint32_t key, VerifierData const& data)>;
+
+// Fetches run under an adaptive concurrency limit (see ConcurrencyLimit.hpp);
+// interactive ones are dispatched ahead of any queued background work. On
+// mobile, background fetches that would wake an idle radio are held and sent
+// together, either when other traffic wakes it or every BATCH_WINDOW seconds.
+// A rate-limited fetch waits out the server's Retry-After, or a jittered
+// backoff, and then goes back in line with the priority it had.
+enum class RequestPriority { Interactive, Background };
+
+// Calls `callback` with the level's data: right away if it is cached or the
+// level sets know the level isn't listed, otherwise once the fetch (new or
+// already in flight) completes. If the fetch fails for any reason but a 404,
+// or failed within the last minute, it gets the expired entry or an empty
+// one. Callbacks always run on the main thread. `callback` may be empty for
+// callers that only want the level fetched and watch for the update through
+// subscribeLevels() instead.
+void resolveLevel(
+    bool platformer, int levelID, bool duo, LevelCallback callback,
+    RequestPriority priority = RequestPriority::Interactive
+);
+
+// Tells the scheduler other traffic just used the network, so held background
+// fetches can go out while the radio is awake anyway.
+void noteNetworkActivity();
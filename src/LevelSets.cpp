@@ -0,0 +1,181 @@
+#include "LevelSets.hpp"
+#include "Common.hpp"
+#include "FileIo.hpp"
+#include "Settings.hpp"
+#include "core/LevelKey.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/file.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace geode::prelude;
+
+static constexpr const char* LEVEL_SETS_FILE = "level_sets.bin";
+// Version 2 keeps 2P-only levels out of Listed; older files are resynced.
+static constexpr uint32_t LEVEL_SETS_MAGIC = 0x32424c56; // "VLB2"
+static constexpr size_t LEVEL_SET_COUNT = 4;
+// Level results are folded into one save this long after the first of them.
+static constexpr float LEVEL_SETS_SAVE_DELAY = 30.f;
+
+struct ListSets {
+    RoaringBitmap sets[LEVEL_SET_COUNT];
+    RoaringBitmap changed; // not persisted
+    long long updatedAt = 0;
+
+    RoaringBitmap& operator[](LevelSet set) {
+        return sets[static_cast<size_t>(set)];
+    }
+};
+
+static ListSets s_lists[2];
+// Changed since the last save.
+static bool s_dirty = false;
+static bool s_saveScheduled = false;
+
+static void saveLevelSets() {
+    if (settings().disableCache) return;
+
+    std::vector<uint8_t> out(sizeof(LEVEL_SETS_MAGIC));
+    std::memcpy(out.data(), &LEVEL_SETS_MAGIC, sizeof(LEVEL_SETS_MAGIC));
+    for (auto const& list : s_lists) {
+        auto at = out.size();
+        out.resize(at + sizeof(list.updatedAt));
+        std::memcpy(out.data() + at, &list.updatedAt, sizeof(list.updatedAt));
+        for (auto const& set : list.sets) set.serialize(out);
+    }
+
+    saveFileAsync(Mod::get()->getSaveDir() / LEVEL_SETS_FILE, std::move(out), LEVEL_SETS_FILE);
+}
+
+void flushLevelSets() {
+    if (!s_dirty) return;
+    s_dirty = false;
+    saveLevelSets();
+}
+
+// A scheduler target that saves the sets once LEVEL_SETS_SAVE_DELAY has
+// passed since they were first changed.
+class LevelSetsSaver : public CCObject {
+public:
+    void onSave(float) {
+        CCScheduler::get()->unscheduleSelector(schedule_selector(LevelSetsSaver::onSave), this);
+        s_saveScheduled = false;
+        flushLevelSets();
+    }
+};
+
+static void markDirty() {
+    s_dirty = true;
+    if (s_saveScheduled) return;
+    // Lives as long as the game does.
+    static auto saver = new LevelSetsSaver();
+    CCScheduler::get()->scheduleSelector(schedule_selector(LevelSetsSaver::onSave), saver, LEVEL_SETS_SAVE_DELAY, false);
+    s_saveScheduled = true;
+}
+
+$on_mod(DataSaved) {
+    flushLevelSets();
+    flushFileIo();
+}
+
+void loadLevelSets() {
+    if (settings().disableCache) return;
+    auto res = file::readBinary(Mod::get()->getSaveDir() / LEVEL_SETS_FILE);
+    if (!res) return;
+
+    auto bytes = res.unwrap();
+    std::span<uint8_t const> in = bytes;
+    uint32_t magic;
+    if (in.size() < sizeof(magic)) return;
+    std::memcpy(&magic, in.data(), sizeof(magic));
+    if (magic != LEVEL_SETS_MAGIC) return;
+    in = in.subspan(sizeof(magic));
+
+    ListSets loaded[2];
+    for (auto& list : loaded) {
+        if (in.size() < sizeof(list.updatedAt)) return;
+        std::memcpy(&list.updatedAt, in.data(), sizeof(list.updatedAt));
+        in = in.subspan(sizeof(list.updatedAt));
+        for (auto& set : list.sets) {
+            auto parsed = RoaringBitmap::deserialize(in);
+            if (!parsed) {
+                log::warn("Ignoring corrupt {}", LEVEL_SETS_FILE);
+                return;
+            }
+            set = std::move(*parsed);
+        }
+    }
+    std::ranges::move(loaded, std::begin(s_lists));
+}
+
+RoaringBitmap const& getLevelSet(bool platformer, LevelSet set) {
+    return s_lists[platformer][set];
+}
+
+void rebuildLevelSets(bool platformer, std::span<SnapshotEntry const> entries, long long syncedAt) {
+    auto& list = s_lists[platformer];
+    RoaringBitmap listed, legacy, twoPlayer;
+    for (auto const& e : entries) {
+        auto id = static_cast<uint32_t>(levelIDFromKey(e.key));
+        if (isDuoKey(e.key)) {
+            twoPlayer.add(id);
+            continue;
+        }
+        listed.add(id);
+        if (e.record.flags & SNAPSHOT_LEGACY) legacy.add(id);
+    }
+
+    // Videos are only learned from level fetches; keep the ones still listed.
+    list[LevelSet::Video] &= listed;
+    list[LevelSet::Listed] = std::move(listed);
+    list[LevelSet::Legacy] = std::move(legacy);
+    list[LevelSet::TwoPlayer] = std::move(twoPlayer);
+    list.changed.clear();
+    list.updatedAt = syncedAt;
+    s_dirty = true;
+    flushLevelSets();
+}
+
+void recordLevelResult(bool platformer, int levelID, bool duo, bool listed, bool legacy, bool hasVideo) {
+    auto& list = s_lists[platformer];
+    auto id = static_cast<uint32_t>(levelID);
+    auto set = [&](LevelSet which, bool value) {
+        if (value) list[which].add(id);
+        else list[which].remove(id);
+    };
+
+    if (duo) {
+        set(LevelSet::TwoPlayer, listed);
+    } else {
+        list.changed.remove(id);
+        set(LevelSet::Listed, listed);
+        set(LevelSet::Legacy, listed && legacy);
+        set(LevelSet::Video, listed && hasVideo);
+    }
+    markDirty();
+}
+
+void markLevelChanged(bool platformer, int levelID) {
+    s_lists[platformer].changed.add(static_cast<uint32_t>(levelID));
+}
+
+bool levelSetsSynced(bool platformer) {
+    return s_lists[platformer].updatedAt != 0;
+}
+
+Membership listMembership(bool platformer, int levelID) {
+    auto& list = s_lists[platformer];
+    auto id = static_cast<uint32_t>(levelID);
+    if (list.updatedAt == 0 || list.changed.contains(id)) return Membership::Unknown;
+    return list[LevelSet::Listed].contains(id) ? Membership::Listed : Membership::Unlisted;
+}
+
+bool isKnownUnlisted(bool platformer, int levelID, bool duo) {
+    if (settings().disableCache) return false;
+    auto& list = s_lists[platformer];
+    if (nowSec() - list.updatedAt > SNAPSHOT_EXPIRY) return false;
+    if (list.changed.contains(static_cast<uint32_t>(levelID))) return false;
+    return !list[duo ? LevelSet::TwoPlayer : LevelSet::Listed].contains(static_cast<uint32_t>(levelID));
+}
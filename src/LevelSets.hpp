@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/RoaringBitmap.hpp"
+#include "core/SnapshotFile.hpp"
+
+#include <span>
+
+// Per-list category sets over level IDs, rebuilt from every snapshot sync and
+// patched by individual level fetches in between. Listed, Legacy and Video
+// describe a level's solo entry; TwoPlayer holds the levels with a 2P entry,
+// which may have no solo one.
+enum class LevelSet {
+    Listed,
+    Legacy,
+    TwoPlayer,
+    Video,
+};
+
+void loadLevelSets();
+// Saves changes from recordLevelResult() now rather than on the save timer.
+// Also runs when the game saves.
+void flushLevelSets();
+
+RoaringBitmap const& getLevelSet(bool platformer, LevelSet set);
+
+void rebuildLevelSets(bool platformer, std::span<SnapshotEntry const> entries, long long syncedAt);
+void recordLevelResult(bool platformer, int levelID, bool duo, bool listed, bool legacy, bool hasVideo);
+
+// Marks a level as changed since the last sync, so its absence from the sets
+// is no longer trusted until it is fetched or the list is synced again.
+void markLevelChanged(bool platformer, int levelID);
+
+enum class Membership { Listed, Unlisted, Unknown };
+
+// True once the list has been synced, however long ago. Until then every
+// level on it is Unknown.
+bool levelSetsSynced(bool platformer);
+
+// Best local answer for a solo level, however old the sets are. Unknown if
+// the list was never synced or the level changed since.
+Membership listMembership(bool platformer, int levelID);
+
+// True when the sets were rebuilt recently enough that a level (or its 2P
+// variant) missing from them can be treated as not listed.
+bool isKnownUnlisted(bool platformer, int levelID, bool duo);
@@ -0,0 +1,99 @@
+#include "Lifecycle.hpp"
+#include "AuditLog.hpp"
+#include "BadgeCache.hpp"
+#include "FileIo.hpp"
+#include "LevelSets.hpp"
+#include "ListSnapshot.hpp"
+#include "Metrics.hpp"
+#include "Thumbnails.hpp"
+#include "VerifierCache.hpp"
+#include "core/Lifecycle.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/modify/AppDelegate.hpp>
+#include <Geode/modify/CCDirector.hpp>
+
+#include <chrono>
+
+using namespace geode::prelude;
+
+// A backgrounded game can be killed without another callback, so pending
+// saves get this long to land.
+static constexpr std::chrono::milliseconds BACKGROUND_BUDGET{1000};
+static constexpr std::chrono::milliseconds LOW_MEMORY_BUDGET{250};
+static constexpr std::chrono::milliseconds FOREGROUND_BUDGET{50};
+
+static void runLifecycle(LifecycleEvent event, std::chrono::milliseconds budget) {
+    auto report = dispatchLifecycle(event, budget);
+    for (auto const& step : report.steps) {
+        log::debug("  {}: {:.2f} ms", step.name, step.seconds * 1000);
+    }
+    if (report.overran) {
+        log::warn(
+            "Handling {} took {:.0f} ms, over its {} ms budget", lifecycleEventName(event), report.seconds * 1000,
+            budget.count()
+        );
+    }
+    else {
+        log::info("Handled {} in {:.1f} ms", lifecycleEventName(event), report.seconds * 1000);
+    }
+}
+
+// Everything is reloaded lazily on next use, so coming back to the
+// foreground needs no handler of its own.
+void initLifecycle() {
+    using enum LifecycleEvent;
+    using enum LifecyclePhase;
+
+    addLifecycleHandler(Persist, "level cache", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event == Background) saveCache();
+    });
+    addLifecycleHandler(Persist, "level sets", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event == Background) flushLevelSets();
+    });
+    addLifecycleHandler(Persist, "audit log", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event == Background) saveAuditLog();
+    });
+    addLifecycleHandler(Persist, "metrics", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event == Background) writeMetrics();
+    });
+    // Low memory too: trimming the snapshots needs their files written.
+    addLifecycleHandler(Flush, "file saves", [](LifecycleEvent event, LifecycleDeadline deadline) {
+        if (event == Foreground) return;
+        if (!flushFileIoUntil(deadline)) log::warn("File saves still pending after {}", lifecycleEventName(event));
+    });
+    addLifecycleHandler(Trim, "thumbnails", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event != Foreground) clearThumbnailMemory();
+    });
+    addLifecycleHandler(Trim, "badges", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event != Foreground) clearBadgeCache();
+    });
+    addLifecycleHandler(Trim, "level cache", [](LifecycleEvent event, LifecycleDeadline deadline) {
+        if (event == LowMemory) dehydrateCache(deadline);
+    });
+    addLifecycleHandler(Trim, "snapshots", [](LifecycleEvent event, LifecycleDeadline) {
+        if (event == LowMemory) trimSnapshots();
+    });
+}
+
+class $modify(VerifierAppDelegate, AppDelegate) {
+    void applicationDidEnterBackground() {
+        AppDelegate::applicationDidEnterBackground();
+        runLifecycle(LifecycleEvent::Background, BACKGROUND_BUDGET);
+    }
+
+    void applicationWillEnterForeground() {
+        AppDelegate::applicationWillEnterForeground();
+        runLifecycle(LifecycleEvent::Foreground, FOREGROUND_BUDGET);
+    }
+};
+
+// cocos2d purges its own caches here when the system warns about memory.
+// Ours go first, so the textures they let go of are purged along with the
+// rest.
+class $modify(VerifierDirector, CCDirector) {
+    void purgeCachedData() {
+        runLifecycle(LifecycleEvent::LowMemory, LOW_MEMORY_BUDGET);
+        CCDirector::purgeCachedData();
+    }
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+// Registers what each subsystem does when the game is backgrounded, returns
+// to the foreground, or the system runs low on memory (see core/Lifecycle.hpp).
+void initLifecycle();
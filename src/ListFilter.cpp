@@ -0,0 +1,141 @@
+#include <Geode/Geode.hpp>
+#include <Geode/modify/LevelBrowserLayer.hpp>
+
+#include "Common.hpp"
+#include "LevelRequests.hpp"
+#include "ListFilter.hpp"
+#include "ListSnapshot.hpp"
+#include "Settings.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace geode::prelude;
+
+// Paging through results while the API is unreachable shouldn't mean one
+// failed sync per page.
+static constexpr long long RESOLVE_RETRY = 60;
+static long long s_lastResolve[2] = {0, 0};
+
+Membership levelMembership(GJGameLevel* level) {
+    auto id = static_cast<int>(level->m_levelID);
+    if (id <= 0 || level->m_demonDifficulty < 5) return Membership::Unlisted;
+    return listMembership(level->isPlatformer(), id);
+}
+
+// Sorts and filters each page in place of the game's order: membership is a
+// bitmap lookup and the position an index probe, so a page costs a few
+// microseconds. Levels the sets can't answer for are kept, and the page is
+// reloaded once they're settled: by one snapshot sync per list that was
+// never synced, or by fetching the few levels changed since the last sync.
+class $modify(VerifierBrowserLayer, LevelBrowserLayer) {
+    struct UnknownLevel {
+        bool platformer;
+        int levelID;
+    };
+
+    void setupLevelBrowser(CCArray* items) {
+        auto const& s = settings();
+        if (!items || (s.listFilter == ListFilter::Off && !s.sortByPosition)) {
+            LevelBrowserLayer::setupLevelBrowser(items);
+            return;
+        }
+
+        struct Row {
+            GJGameLevel* level;
+            uint32_t position;
+        };
+        static constexpr uint32_t UNLISTED = std::numeric_limits<uint32_t>::max();
+
+        std::vector<Row> rows;
+        rows.reserve(items->count());
+        std::vector<UnknownLevel> unknown;
+        for (auto obj : CCArrayExt<CCObject*>(items)) {
+            auto level = typeinfo_cast<GJGameLevel*>(obj);
+            // Lists of lists or users are left alone.
+            if (!level) {
+                LevelBrowserLayer::setupLevelBrowser(items);
+                return;
+            }
+
+            auto membership = levelMembership(level);
+            if (membership == Membership::Unknown) {
+                unknown.push_back({level->isPlatformer(), static_cast<int>(level->m_levelID)});
+            }
+            if (membership == Membership::Unlisted && s.listFilter == ListFilter::Hide) continue;
+
+            uint32_t position = UNLISTED;
+            if (membership == Membership::Listed) {
+                auto record = findInSnapshot(level->isPlatformer(), static_cast<int>(level->m_levelID), false);
+                if (record) position = record->position;
+            }
+            rows.push_back({level, position});
+        }
+
+        if (s.sortByPosition) {
+            std::ranges::stable_sort(rows, {}, &Row::position);
+        }
+
+        // The original array may be the game's cached search result.
+        auto filtered = CCArray::createWithCapacity(rows.size());
+        for (auto const& row : rows) filtered->addObject(row.level);
+        LevelBrowserLayer::setupLevelBrowser(filtered);
+
+        if (!s.offlineMode && !unknown.empty()) resolveUnknown(std::move(unknown));
+    }
+
+    void resolveUnknown(std::vector<UnknownLevel> levels) {
+        std::vector<UnknownLevel> changed;
+        for (bool platformer : {false, true}) {
+            auto inList = [platformer](UnknownLevel const& level) { return level.platformer == platformer; };
+            if (!std::ranges::any_of(levels, inList)) continue;
+            if (levelSetsSynced(platformer)) std::ranges::copy_if(levels, std::back_inserter(changed), inList);
+            else syncList(platformer);
+        }
+        if (!changed.empty()) fetchChanged(std::move(changed));
+    }
+
+    // Joins a sync already running, e.g. from another page.
+    void syncList(bool platformer) {
+        if (nowSec() - s_lastResolve[platformer] < RESOLVE_RETRY) return;
+        s_lastResolve[platformer] = nowSec();
+
+        WeakRef<VerifierBrowserLayer> self = this;
+        syncSnapshotNow(platformer, [self](bool ok) {
+            auto layer = self.lock();
+            if (ok && layer && layer->m_searchObject) layer->loadPage(layer->m_searchObject);
+        });
+    }
+
+    // Only levels the changelog marked since the last sync get here. One
+    // that is still unknown after its fetch (a failure) doesn't reload the
+    // page, so reloading can't loop; the request path throttles retries.
+    void fetchChanged(std::vector<UnknownLevel> levels) {
+        struct Batch {
+            std::vector<UnknownLevel> levels;
+            size_t remaining;
+        };
+        auto batch = std::make_shared<Batch>(Batch{std::move(levels), 0});
+        batch->remaining = batch->levels.size();
+
+        WeakRef<VerifierBrowserLayer> self = this;
+        auto onResult = [self, batch](uint32_t, VerifierData const&) {
+            if (--batch->remaining > 0) return;
+            bool settled = std::ranges::any_of(batch->levels, [](UnknownLevel const& level) {
+                return listMembership(level.platformer, level.levelID) != Membership::Unknown;
+            });
+            if (!settled) return;
+            // Not from inside setupLevelBrowser() if every answer was cached.
+            Loader::get()->queueInMainThread([self] {
+                auto layer = self.lock();
+                if (layer && layer->m_searchObject) layer->loadPage(layer->m_searchObject);
+            });
+        };
+        for (auto const& level : batch->levels) {
+            resolveLevel(level.platformer, level.levelID, false, onResult, RequestPriority::Background);
+        }
+    }
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "LevelSets.hpp"
+
+#include <Geode/Geode.hpp>
+
+// List membership of a browsed level, from local data only. Anything that
+// isn't an Extreme Demon is unlisted without looking.
+Membership levelMembership(GJGameLevel* level);
@@ -0,0 +1,151 @@
+#include "ListSnapshot.hpp"
+#include "Common.hpp"
+#include "FileIo.hpp"
+#include "JsonBackend.hpp"
+#include "LevelRequests.hpp"
+#include "LevelSets.hpp"
+#include "Metrics.hpp"
+#include "Settings.hpp"
+#include "core/MappedFile.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/web.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+using namespace geode::prelude;
+
+static constexpr long long SNAPSHOT_RETRY = 300;
+
+struct ListSnapshot {
+    bool platformer;
+    const char* file;
+    const char* api;
+    MappedFile mapped;
+    std::vector<uint8_t> owned;
+    std::optional<SnapshotView> view;
+    async::TaskHolder<web::WebResponse> task;
+    long long lastAttempt = 0;
+    bool syncing = false;
+    std::vector<std::function<void(bool)>> waiters;
+};
+
+static ListSnapshot s_snapshots[2] = {
+    {false, "aredl_snapshot.bin", CLASSIC_API},
+    {true, "arepl_snapshot.bin", PLATFORMER_API},
+};
+
+static bool cacheDisabled() {
+    return settings().disableCache;
+}
+
+static void installSnapshot(ListSnapshot& snap, std::vector<uint8_t> bytes) {
+    // Windows refuses to overwrite a mapped file, so drop the mapping first.
+    snap.view.reset();
+    snap.mapped = MappedFile();
+    snap.owned = std::move(bytes);
+    snap.view = SnapshotView::parse(snap.owned);
+
+    if (cacheDisabled()) return;
+    saveFileAsync(Mod::get()->getSaveDir() / snap.file, snap.owned, snap.file);
+}
+
+static void finishSync(ListSnapshot& snap, bool ok) {
+    snap.syncing = false;
+    for (auto& waiter : std::exchange(snap.waiters, {})) waiter(ok);
+}
+
+static void syncSnapshot(ListSnapshot& snap) {
+    snap.syncing = true;
+    snap.lastAttempt = nowSec();
+    auto sentAt = std::chrono::steady_clock::now();
+
+    snap.task.spawn(web::WebRequest().userAgent(USER_AGENT).get(snap.api), [&snap, sentAt](web::WebResponse res) {
+        std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - sentAt;
+        metrics::recordResponse(res.code(), true, res.data().size(), rtt.count());
+        noteNetworkActivity();
+        if (!res.ok()) {
+            log::debug("Snapshot request for {} failed: {}", snap.file, res.code());
+            finishSync(snap, false);
+            return;
+        }
+
+        auto entries = JsonBackend::parseList(asJsonText(res.data()));
+        if (!entries) {
+            log::debug("Failed to parse snapshot response for {}", snap.file);
+            finishSync(snap, false);
+            return;
+        }
+
+        log::info("Synced {} with {} levels", snap.file, entries->size());
+        auto syncedAt = nowSec();
+        rebuildLevelSets(snap.platformer, *entries, syncedAt);
+        installSnapshot(snap, encodeSnapshot(std::move(*entries), syncedAt));
+        finishSync(snap, true);
+    });
+}
+
+void loadSnapshots() {
+    if (cacheDisabled()) return;
+    for (auto& snap : s_snapshots) {
+        auto mapped = MappedFile::open(Mod::get()->getSaveDir() / snap.file);
+        if (!mapped) continue;
+        snap.view = SnapshotView::parse(mapped->bytes());
+        if (!snap.view) {
+            log::warn("Ignoring invalid snapshot {}", snap.file);
+            continue;
+        }
+        snap.mapped = std::move(*mapped);
+    }
+}
+
+void trimSnapshots() {
+    if (cacheDisabled()) return;
+    for (auto& snap : s_snapshots) {
+        if (snap.owned.empty()) continue;
+        auto mapped = MappedFile::open(Mod::get()->getSaveDir() / snap.file);
+        // A save still in flight leaves the previous file in place.
+        if (!mapped || !std::ranges::equal(mapped->bytes(), snap.owned)) continue;
+        auto view = SnapshotView::parse(mapped->bytes());
+        if (!view) continue;
+        snap.view = view;
+        snap.mapped = std::move(*mapped);
+        std::vector<uint8_t>().swap(snap.owned);
+    }
+}
+
+void syncSnapshotIfStale(bool platformer) {
+    if (cacheDisabled()) return;
+    auto& snap = s_snapshots[platformer];
+    if (snap.syncing || hasFreshSnapshot(platformer)) return;
+    if (nowSec() - snap.lastAttempt < SNAPSHOT_RETRY) return;
+    syncSnapshot(snap);
+}
+
+void syncSnapshotNow(bool platformer, std::function<void(bool)> done) {
+    auto& snap = s_snapshots[platformer];
+    snap.waiters.push_back(std::move(done));
+    if (!snap.syncing) syncSnapshot(snap);
+}
+
+bool hasFreshSnapshot(bool platformer) {
+    if (cacheDisabled()) return false;
+    auto const& snap = s_snapshots[platformer];
+    return snap.view && nowSec() - snap.view->syncedAt() <= SNAPSHOT_EXPIRY;
+}
+
+std::optional<long long> snapshotSyncedAt(bool platformer) {
+    auto const& snap = s_snapshots[platformer];
+    if (!snap.view) return std::nullopt;
+    return snap.view->syncedAt();
+}
+
+SnapshotRecord const* findInSnapshot(bool platformer, int levelID, bool duo) {
+    auto const& snap = s_snapshots[platformer];
+    if (!snap.view) return nullptr;
+    return snap.view->find(packLevelKey(levelID, duo));
+}
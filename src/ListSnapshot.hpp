@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/SnapshotFile.hpp"
+
+#include <functional>
+#include <optional>
+
+// Bulk AREDL/AREPL level lists. Each list is fetched in one request at most
+// every SNAPSHOT_EXPIRY seconds and kept on disk as an index that is mapped
+// back in on startup instead of being parsed.
+
+void loadSnapshots();
+// Swaps a freshly synced snapshot's heap copy for a mapping of its saved file,
+// once that file is on disk.
+void trimSnapshots();
+void syncSnapshotIfStale(bool platformer);
+// Syncs regardless of age and reports whether it worked. Joins a sync that
+// is already running.
+void syncSnapshotNow(bool platformer, std::function<void(bool ok)> done);
+
+// True when a snapshot newer than SNAPSHOT_EXPIRY can answer membership.
+bool hasFreshSnapshot(bool platformer);
+
+// When the snapshot on hand was synced, however old.
+std::optional<long long> snapshotSyncedAt(bool platformer);
+
+// Returns the list record for a level, or nullptr if it isn't listed.
+SnapshotRecord const* findInSnapshot(bool platformer, int levelID, bool duo);
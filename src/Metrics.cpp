@@ -0,0 +1,110 @@
+#include "Metrics.hpp"
+#include "FileIo.hpp"
+
+#include <Geode/Geode.hpp>
+
+using namespace geode::prelude;
+
+static constexpr const char* METRICS_FILE = "metrics.prom";
+static constexpr float METRICS_INTERVAL = 60.f;
+
+namespace metrics {
+    static constexpr const char* LOOKUPS_HELP = "Verifier cache lookups by result.";
+    Counter cacheHits{"verifier_cache_lookups", LOOKUPS_HELP, R"(result="hit")"};
+    Counter cacheMisses{"verifier_cache_lookups", LOOKUPS_HELP, R"(result="miss")"};
+    Counter cacheStale{"verifier_cache_lookups", LOOKUPS_HELP, R"(result="stale")"};
+    Counter cacheEvictions{"verifier_cache_evictions", "Entries evicted from the session cache."};
+    Histogram cacheSaveDuration{
+        "verifier_cache_save_seconds", "Time to write the cache file.", {0.001, 0.005, 0.01, 0.05, 0.1, 0.5}
+    };
+    Histogram cacheLoadDuration{
+        "verifier_cache_load_seconds", "Time to read the cache file.", {0.001, 0.005, 0.01, 0.05, 0.1, 0.5}
+    };
+    Histogram cacheHotLoadDuration{
+        "verifier_cache_hot_load_seconds", "Time until the hottest cache entries were usable after a load.",
+        {0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05}
+    };
+
+    Gauge requestQueueDepth{"verifier_request_queue_depth", "Level requests waiting for a free slot."};
+    Gauge requestsInFlight{"verifier_requests_in_flight", "Level requests currently running."};
+    Gauge requestConcurrencyLimit{"verifier_request_concurrency_limit", "Current adaptive concurrency limit."};
+    Gauge requestsHeld{"verifier_requests_held", "Background level requests waiting for the next burst."};
+    Counter radioBursts{"verifier_radio_bursts", "Network bursts that woke the radio from idle."};
+    Histogram radioBurstRequests{
+        "verifier_radio_burst_requests", "Level requests sent per burst.", {1, 2, 4, 8, 16, 32, 64}
+    };
+
+    static constexpr const char* THUMBNAILS_HELP = "Thumbnail requests by where they were served from.";
+    Counter thumbnailMemoryHits{"verifier_thumbnail_lookups", THUMBNAILS_HELP, R"(result="memory")"};
+    Counter thumbnailDiskHits{"verifier_thumbnail_lookups", THUMBNAILS_HELP, R"(result="disk")"};
+    Counter thumbnailMisses{"verifier_thumbnail_lookups", THUMBNAILS_HELP, R"(result="miss")"};
+    Histogram thumbnailDecodeDuration{
+        "verifier_thumbnail_decode_seconds", "Worker time to decode and downscale a thumbnail.",
+        {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05}
+    };
+    Histogram thumbnailUploadDuration{
+        "verifier_thumbnail_upload_seconds", "Main thread time to upload a thumbnail texture.",
+        {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005}
+    };
+
+    static constexpr const char* REQUESTS_HELP = "HTTP responses by status class and priority.";
+    static Counter s_requests[2][5] = {
+        {
+            {"verifier_requests", REQUESTS_HELP, R"(priority="interactive",status="ok")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="interactive",status="not_found")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="interactive",status="rate_limited")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="interactive",status="server_error")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="interactive",status="failed")"},
+        },
+        {
+            {"verifier_requests", REQUESTS_HELP, R"(priority="background",status="ok")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="background",status="not_found")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="background",status="rate_limited")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="background",status="server_error")"},
+            {"verifier_requests", REQUESTS_HELP, R"(priority="background",status="failed")"},
+        },
+    };
+    static Counter s_responseBytes{"verifier_response_bytes", "Response body bytes received."};
+    static Histogram s_requestDuration{
+        "verifier_request_seconds", "HTTP round trip time.", {0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10}
+    };
+
+    void recordResponse(int code, bool background, size_t bytes, double seconds) {
+        size_t status = code >= 200 && code < 300 ? 0
+            : code == 404 ? 1
+            : code == 429 ? 2
+            : code >= 500 ? 3
+            : 4;
+        s_requests[background][status].add();
+        s_responseBytes.add(bytes);
+        s_requestDuration.observe(seconds);
+    }
+}
+
+// A scheduler target for the periodic write.
+class MetricsWriter : public CCObject {
+public:
+    void onTick(float) {
+        writeMetrics();
+    }
+};
+
+// Deferred to the first frame, when the scheduler is certain to be running.
+void initMetrics() {
+    Loader::get()->queueInMainThread([] {
+        // Lives as long as the game does.
+        auto writer = new MetricsWriter();
+        CCScheduler::get()->scheduleSelector(schedule_selector(MetricsWriter::onTick), writer, METRICS_INTERVAL, false);
+    });
+}
+
+// Replaced atomically, so a collector never reads half a file.
+void writeMetrics() {
+    auto text = formatOpenMetrics();
+    saveFileAsync(Mod::get()->getSaveDir() / METRICS_FILE, std::vector<uint8_t>(text.begin(), text.end()), METRICS_FILE);
+}
+
+$on_mod(DataSaved) {
+    writeMetrics();
+    flushFileIo();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/Metrics.hpp"
+
+#include <cstddef>
+
+// The mod's metrics, written to metrics.prom in the save directory every
+// METRICS_INTERVAL seconds and when the game saves on exit.
+namespace metrics {
+    extern Counter cacheHits;
+    extern Counter cacheMisses;
+    // Entries present but too old to serve.
+    extern Counter cacheStale;
+    extern Counter cacheEvictions;
+    extern Histogram cacheSaveDuration;
+    // Parse time for the whole file, then time until the hot head was usable.
+    extern Histogram cacheLoadDuration;
+    extern Histogram cacheHotLoadDuration;
+
+    extern Gauge requestQueueDepth;
+    extern Gauge requestsInFlight;
+    extern Gauge requestConcurrencyLimit;
+    // Background requests held for the next burst.
+    extern Gauge requestsHeld;
+    // A burst starts with the first request after RADIO_TAIL seconds without
+    // network traffic; its size is observed when the next one starts.
+    extern Counter radioBursts;
+    extern Histogram radioBurstRequests;
+
+    // Thumbnail requests by where they were served from.
+    extern Counter thumbnailMemoryHits;
+    extern Counter thumbnailDiskHits;
+    extern Counter thumbnailMisses;
+    extern Histogram thumbnailDecodeDuration;
+    extern Histogram thumbnailUploadDuration;
+
+    // Counts one HTTP response by status class and priority, with its size
+    // and round trip.
+    void recordResponse(int code, bool background, size_t bytes, double seconds);
+}
+
+void initMetrics();
+void writeMetrics();
@@ -0,0 +1,191 @@
+#include "RecordsPopup.hpp"
+#include "Common.hpp"
+#include "JsonBackend.hpp"
+#include "LevelRequests.hpp"
+#include "Metrics.hpp"
+#include "core/LevelKey.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace geode::prelude;
+
+static constexpr float POPUP_WIDTH = 320.f;
+static constexpr float POPUP_HEIGHT = 250.f;
+static constexpr float LIST_WIDTH = 280.f;
+static constexpr float LIST_HEIGHT = 180.f;
+static constexpr float ROW_HEIGHT = 20.f;
+static constexpr size_t PAGE_SIZE = 50;
+static constexpr size_t READ_AHEAD_PAGES = 1;
+// Loaded pages kept on each side of the visible ones; bounds memory.
+static constexpr size_t KEEP_PAGES = 2;
+
+static double monotonicSec() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+RecordsPopup::RecordsPopup() : m_pager(PAGE_SIZE, READ_AHEAD_PAGES, KEEP_PAGES) {}
+
+RecordsPopup* RecordsPopup::create(bool platformer, uint32_t key, std::string const& verifier) {
+    auto ret = new RecordsPopup();
+    if (ret->init(platformer, key, verifier)) {
+        ret->autorelease();
+        return ret;
+    }
+    delete ret;
+    return nullptr;
+}
+
+bool RecordsPopup::init(bool platformer, uint32_t key, std::string const& verifier) {
+    if (!Popup::init(POPUP_WIDTH, POPUP_HEIGHT)) return false;
+    m_platformer = platformer;
+    m_key = key;
+    this->setTitle(isDuoKey(key) ? "Records (2P)" : "Records");
+
+    auto center = m_mainLayer->getContentSize() / 2;
+    auto verifiedBy = CCLabelBMFont::create(("Verified by " + verifier).c_str(), "goldFont.fnt");
+    verifiedBy->limitLabelWidth(LIST_WIDTH, 0.5f, 0.1f);
+    verifiedBy->setPosition(center + ccp(0, LIST_HEIGHT / 2 + 14.f));
+    m_mainLayer->addChild(verifiedBy);
+
+    m_scroll = ScrollLayer::create({LIST_WIDTH, LIST_HEIGHT});
+    m_scroll->setPosition(center - ccp(LIST_WIDTH / 2, LIST_HEIGHT / 2 + 8.f));
+    m_scroll->setID("records-list"_spr);
+    m_mainLayer->addChild(m_scroll);
+
+    // Enough rows to cover the view at any offset.
+    auto slots = static_cast<size_t>(std::ceil(LIST_HEIGHT / ROW_HEIGHT)) + 1;
+    for (size_t i = 0; i < slots; ++i) {
+        RowSlot slot;
+        slot.node = CCNode::create();
+        slot.node->setContentSize({LIST_WIDTH, ROW_HEIGHT});
+        slot.node->setVisible(false);
+
+        slot.background = CCLayerColor::create({0, 0, 0, 40}, LIST_WIDTH, ROW_HEIGHT);
+        slot.node->addChild(slot.background);
+
+        slot.position = CCLabelBMFont::create("", "bigFont.fnt");
+        slot.position->setScale(0.35f);
+        slot.position->setAnchorPoint({0, 0.5f});
+        slot.position->setPosition({6.f, ROW_HEIGHT / 2});
+        slot.node->addChild(slot.position);
+
+        slot.player = CCLabelBMFont::create("", "chatFont.fnt");
+        slot.player->setScale(0.7f);
+        slot.player->setAnchorPoint({0, 0.5f});
+        slot.player->setPosition({44.f, ROW_HEIGHT / 2});
+        slot.node->addChild(slot.player);
+
+        m_scroll->m_contentLayer->addChild(slot.node);
+        m_slots.push_back(slot);
+    }
+
+    m_status = CCLabelBMFont::create("Loading...", "chatFont.fnt");
+    m_status->setScale(0.6f);
+    m_status->setPosition(center - ccp(0, LIST_HEIGHT / 2 + 18.f));
+    m_mainLayer->addChild(m_status);
+
+    resizeContent();
+    m_scroll->scrollToTop();
+    this->schedule(schedule_selector(RecordsPopup::onFrame));
+    return true;
+}
+
+float RecordsPopup::scrolled() const {
+    auto content = m_scroll->m_contentLayer;
+    return content->getPositionY() - (LIST_HEIGHT - content->getContentSize().height);
+}
+
+// Keeps the same distance from the top when rows are added at the bottom.
+void RecordsPopup::resizeContent() {
+    auto content = m_scroll->m_contentLayer;
+    // Nothing is laid out before the first call.
+    float offset = m_rowCount ? scrolled() : 0.f;
+    m_rowCount = m_pager.rowCount();
+
+    float height = std::max(LIST_HEIGHT, m_rowCount * ROW_HEIGHT);
+    content->setContentSize({LIST_WIDTH, height});
+    content->setPositionY(std::min(0.f, offset + LIST_HEIGHT - height));
+    for (auto& slot : m_slots) slot.bound.reset();
+}
+
+void RecordsPopup::bindRow(RowSlot& slot, size_t index) {
+    slot.node->setVisible(true);
+    slot.node->setPositionY(m_scroll->m_contentLayer->getContentSize().height - (index + 1) * ROW_HEIGHT);
+    slot.background->setOpacity(index % 2 ? 0 : 40);
+
+    auto row = m_pager.row(index);
+    slot.bound = index;
+
+    auto position = fmt::format("#{}", index + 1);
+    slot.position->setString(position.c_str());
+    if (row) {
+        auto text = row->mobile ? row->player + "  (mobile)" : row->player;
+        slot.player->setString(text.c_str());
+        slot.player->setOpacity(255);
+    }
+    else {
+        slot.player->setString(m_pager.failed(index) ? "Failed to load, retrying..." : "...");
+        slot.player->setOpacity(120);
+    }
+}
+
+void RecordsPopup::onFrame(float) {
+    for (auto page : std::exchange(m_finished, {})) m_tasks.erase(page);
+
+    if (m_rowCount != m_pager.rowCount()) resizeContent();
+
+    auto first = static_cast<size_t>(std::max(0.f, scrolled()) / ROW_HEIGHT);
+    auto last = static_cast<size_t>(std::max(0.f, scrolled() + LIST_HEIGHT) / ROW_HEIGHT);
+    for (auto page : m_pager.update(first, last, monotonicSec())) fetchPage(page);
+
+    // Slots cover consecutive rows starting at `first`; each is rebound
+    // only when the row it shows changes or a page arrived.
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        auto& slot = m_slots[i];
+        auto index = first + i;
+        if (index >= m_rowCount) {
+            slot.node->setVisible(false);
+            slot.bound.reset();
+            continue;
+        }
+        if (slot.bound != index || m_dirty) bindRow(slot, index);
+    }
+    m_dirty = false;
+}
+
+void RecordsPopup::fetchPage(size_t page) {
+    auto url = fmt::format(
+        "{}/{}/records?page={}&per_page={}", m_platformer ? PLATFORMER_API : CLASSIC_API, formatLevelKey(m_key),
+        page + 1, PAGE_SIZE
+    );
+    auto sentAt = std::chrono::steady_clock::now();
+
+    // The holder lives in the popup, so closing it cancels the request and
+    // the callback never sees a dead `this`.
+    m_tasks[page].spawn(web::WebRequest().userAgent(USER_AGENT).get(url), [this, page, sentAt](web::WebResponse res) {
+        std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - sentAt;
+        metrics::recordResponse(res.code(), false, res.data().size(), rtt.count());
+        noteNetworkActivity();
+        m_finished.push_back(page);
+        m_dirty = true;
+
+        auto records = res.ok() ? reduceRecordsPage(asJsonText(res.data())) : std::nullopt;
+        if (!records) {
+            log::debug("Records page {} for {} failed: {}", page, formatLevelKey(m_key), res.code());
+            m_pager.onPageFailed(page, monotonicSec());
+            m_status->setString("Some records failed to load, retrying");
+            return;
+        }
+        m_pager.onPage(page, std::move(*records));
+        if (m_pager.complete()) {
+            auto count = m_pager.rowCount();
+            m_status->setString(count == 0 ? "No records yet" : fmt::format("{} records", count).c_str());
+        }
+        else {
+            m_status->setString("");
+        }
+    });
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/RecordPager.hpp"
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/web.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Every record of a level in a virtualized list: only the rows on screen
+// exist as nodes and are rebound as the list scrolls, and pages are fetched
+// as they come into view (see RecordPager).
+class RecordsPopup : public geode::Popup {
+public:
+    static RecordsPopup* create(bool platformer, uint32_t key, std::string const& verifier);
+
+protected:
+    struct RowSlot {
+        cocos2d::CCNode* node = nullptr;
+        cocos2d::CCLayerColor* background = nullptr;
+        cocos2d::CCLabelBMFont* position = nullptr;
+        cocos2d::CCLabelBMFont* player = nullptr;
+        std::optional<size_t> bound;
+    };
+
+    bool init(bool platformer, uint32_t key, std::string const& verifier);
+    void onFrame(float);
+    void fetchPage(size_t page);
+    void resizeContent();
+    void bindRow(RowSlot& slot, size_t index);
+    // How far the list is scrolled from the top, in points.
+    float scrolled() const;
+
+    bool m_platformer = false;
+    uint32_t m_key = 0;
+    RecordPager m_pager;
+    geode::ScrollLayer* m_scroll = nullptr;
+    cocos2d::CCLabelBMFont* m_status = nullptr;
+    std::vector<RowSlot> m_slots;
+    std::unordered_map<size_t, geode::async::TaskHolder<geode::utils::web::WebResponse>> m_tasks;
+    // Finished requests, dropped next frame rather than inside their own callback.
+    std::vector<size_t> m_finished;
+    size_t m_rowCount = 0;
+    bool m_dirty = true;
+
+    RecordsPopup();
+};
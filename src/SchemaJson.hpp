@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/Schema.hpp"
+
+#include <Geode/Result.hpp>
+#include <matjson.hpp>
+
+#include <concepts>
+#include <string>
+
+// matjson codec generated from a Schema. Decoding walks the object's members
+// once and dispatches each to its field by name, instead of a contains() plus
+// operator[] lookup per field.
+
+inline void readJsonValue(matjson::Value const& v, std::string& out) {
+    out = v.asString().unwrapOr("");
+}
+
+inline void readJsonValue(matjson::Value const& v, bool& out) {
+    out = v.asBool().unwrapOr(false);
+}
+
+template <std::signed_integral T>
+void readJsonValue(matjson::Value const& v, T& out) {
+    out = static_cast<T>(v.asInt().unwrapOr(0));
+}
+
+template <HasSchema T>
+matjson::Value schemaToJson(T const& value) {
+    auto obj = matjson::Value::object();
+    forEachField<T>([&](auto const& f) { obj.set(f.name, value.*f.member); });
+    return obj;
+}
+
+template <HasSchema T>
+geode::Result<T> schemaFromJson(matjson::Value const& v) {
+    if (!v.isObject()) return geode::Err("expected object");
+    T out{};
+    for (auto const& [key, member] : v) {
+        visitField<T>(key, [&](auto const& f) { readJsonValue(member, out.*f.member); });
+    }
+    return geode::Ok(std::move(out));
+}
@@ -0,0 +1,39 @@
+#include "Settings.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <string>
+#include <string_view>
+
+using namespace geode::prelude;
+
+static Settings s_settings;
+
+template <class T, class F>
+static void mirror(std::string_view key, F apply) {
+    apply(Mod::get()->getSettingValue<T>(key));
+    listenForSettingChanges<T>(key, apply);
+}
+
+void initSettings() {
+    mirror<bool>("show-label", [](bool v) { s_settings.showLabel = v; });
+    mirror<bool>("show-in-lists", [](bool v) { s_settings.showInLists = v; });
+    mirror<std::string>("list-filter", [](std::string v) {
+        s_settings.listFilter = v == "Hide Unlisted" ? ListFilter::Hide
+            : v == "Gray Out Unlisted" ? ListFilter::Gray
+            : ListFilter::Off;
+    });
+    mirror<bool>("sort-by-position", [](bool v) { s_settings.sortByPosition = v; });
+    mirror<std::string>("label-alignment", [](std::string v) { s_settings.leftAligned = v == "Left"; });
+    mirror<double>("y-offset", [](double v) { s_settings.yOffset = static_cast<float>(v); });
+    mirror<bool>("legacy-color", [](bool v) { s_settings.legacyColor = v; });
+    mirror<bool>("show-youtube", [](bool v) { s_settings.showYoutube = v; });
+    mirror<bool>("video-preview", [](bool v) { s_settings.videoPreview = v; });
+    mirror<bool>("disable-cache", [](bool v) { s_settings.disableCache = v; });
+    mirror<bool>("offline-mode", [](bool v) { s_settings.offlineMode = v; });
+    mirror<bool>("audit-log", [](bool v) { s_settings.auditLog = v; });
+}
+
+Settings const& settings() {
+    return s_settings;
+}
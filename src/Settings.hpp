@@ -0,0 +1,23 @@
+#pragma once
+
+enum class ListFilter { Off, Gray, Hide };
+
+// Setting values mirrored into plain fields, so hot paths read a bool instead
+// of going through a string-keyed setting lookup every time.
+struct Settings {
+    bool showLabel = true;
+    bool showInLists = false;
+    ListFilter listFilter = ListFilter::Off;
+    bool sortByPosition = false;
+    bool leftAligned = false;
+    float yOffset = -8.f;
+    bool legacyColor = true;
+    bool showYoutube = true;
+    bool videoPreview = false;
+    bool disableCache = false;
+    bool offlineMode = false;
+    bool auditLog = false;
+};
+
+void initSettings();
+Settings const& settings();
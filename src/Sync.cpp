@@ -0,0 +1,109 @@
+#include "Sync.hpp"
+#include "Changelog.hpp"
+#include "LevelRequests.hpp"
+#include "LevelSets.hpp"
+#include "ListSnapshot.hpp"
+#include "VerifierCache.hpp"
+#include "core/LevelKey.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+using namespace geode::prelude;
+
+// Steps before the per-level refetches: one per list snapshot.
+static constexpr size_t SNAPSHOT_STEPS = 2;
+
+struct SyncState {
+    SyncProgress progress;
+    std::vector<SyncCallback> listeners;
+};
+
+static std::optional<SyncState> s_sync;
+
+static void report() {
+    for (auto const& listener : s_sync->listeners) listener(s_sync->progress);
+}
+
+static void finishSync() {
+    auto state = std::move(*s_sync);
+    s_sync.reset();
+    state.progress.finished = true;
+    log::info(
+        "Sync {} after {} of {} steps",
+        state.progress.ok ? "finished" : "finished with errors", state.progress.done, state.progress.total
+    );
+    for (auto const& listener : state.listeners) listener(state.progress);
+}
+
+static void stepDone() {
+    ++s_sync->progress.done;
+    if (s_sync->progress.done == s_sync->progress.total) finishSync();
+    else report();
+}
+
+// The list holding `key`, if either does.
+static std::optional<bool> listedOn(uint32_t key) {
+    auto id = static_cast<uint32_t>(levelIDFromKey(key));
+    auto set = isDuoKey(key) ? LevelSet::TwoPlayer : LevelSet::Listed;
+    for (bool platformer : {false, true}) {
+        if (getLevelSet(platformer, set).contains(id)) return platformer;
+    }
+    return std::nullopt;
+}
+
+// Every cached level whose entry has expired is fetched again, or settled
+// locally when the fresh snapshots show it isn't listed. Levels never opened
+// aren't fetched: the snapshots already answer whether they're listed. The
+// lists say which API a level belongs to; one no list holds goes by its entry.
+static void refreshLevels() {
+    // Key to platformer. Collected first, since fetches store into the cache.
+    std::vector<std::pair<uint32_t, bool>> levels;
+    forEachCached([&](uint32_t key, VerifierData const& data) {
+        if (!isCachedFresh(data)) levels.emplace_back(key, listedOn(key).value_or(data.platformer));
+    });
+
+    s_sync->progress.total += levels.size();
+    if (levels.empty()) {
+        finishSync();
+        return;
+    }
+    report();
+
+    for (auto [key, platformer] : levels) {
+        resolveLevel(
+            platformer, levelIDFromKey(key), isDuoKey(key), [](uint32_t, VerifierData const&) { stepDone(); },
+            RequestPriority::Background
+        );
+    }
+}
+
+void startSync(SyncCallback onProgress) {
+    if (s_sync) {
+        s_sync->listeners.push_back(std::move(onProgress));
+        s_sync->listeners.back()(s_sync->progress);
+        return;
+    }
+
+    s_sync.emplace();
+    s_sync->progress.total = SNAPSHOT_STEPS;
+    s_sync->listeners.push_back(std::move(onProgress));
+    report();
+
+    pollChangelogIfDue();
+    for (bool platformer : {false, true}) {
+        syncSnapshotNow(platformer, [](bool ok) {
+            if (!ok) s_sync->progress.ok = false;
+            ++s_sync->progress.done;
+            if (s_sync->progress.done == SNAPSHOT_STEPS) refreshLevels();
+            else report();
+        });
+    }
+}
+
+bool isSyncing() {
+    return s_sync.has_value();
+}
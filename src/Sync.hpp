@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// The "sync now" bulk update used by offline mode: both list snapshots in one
+// request each, then a fetch of every expired cache entry they don't settle,
+// so levels already seen open from local data. Levels never opened are left
+// to the snapshots.
+
+struct SyncProgress {
+    size_t done = 0;
+    size_t total = 0;
+    bool finished = false;
+    // False if any step failed; whatever did sync is still kept.
+    bool ok = true;
+};
+
+using SyncCallback = std::function<void(SyncProgress const& progress)>;
+
+// Starts a sync, or joins the running one. `onProgress` runs on the main
+// thread after every step and once more with `finished` set.
+void startSync(SyncCallback onProgress);
+bool isSyncing();
@@ -0,0 +1,249 @@
+#include "Thumbnails.hpp"
+#include "Common.hpp"
+#include "LevelRequests.hpp"
+#include "Metrics.hpp"
+#include "Settings.hpp"
+#include "core/DiskLru.hpp"
+#include "core/FileSink.hpp"
+#include "core/Thumbnail.hpp"
+#include "core/TtlCache.hpp"
+#include "core/WorkQueue.hpp"
+
+#include <Geode/utils/web.hpp>
+
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace geode::prelude;
+
+static constexpr const char* THUMBNAIL_DIR = "thumbnails";
+static constexpr uint64_t THUMBNAIL_CACHE_BYTES = 8 * 1024 * 1024;
+static constexpr int THUMBNAIL_WIDTH = 192;
+static constexpr size_t THUMBNAIL_MEMORY_MAX = 8;
+// One decode worker: a decode takes a few milliseconds, and more threads
+// would only compete with the game for cores on phones. At most a screenful
+// waits; rapid toggling drops the oldest requests.
+static constexpr size_t DECODE_THREADS = 1;
+static constexpr size_t DECODE_QUEUE_MAX = THUMBNAIL_MEMORY_MAX;
+// Main thread time spent on uploads per frame; one always goes through.
+static constexpr std::chrono::microseconds UPLOAD_BUDGET{2000};
+
+using TextureCache = ttl::TtlCache<
+    std::string, Ref<CCTexture2D>, ttl::NoCodec, ttl::LruEviction<std::string>, ttl::NeverExpire, ttl::NoPersistence
+>;
+
+struct PendingThumbnail {
+    std::vector<ThumbnailCallback> callbacks;
+    async::TaskHolder<web::WebResponse> task;
+};
+
+struct DecodedThumbnail {
+    std::string id;
+    RgbaImage image;
+    // Size of the file the worker wrote, if it came from the network.
+    std::optional<uint64_t> storedBytes;
+};
+
+static std::unordered_map<std::string, PendingThumbnail> s_pending;
+static std::deque<DecodedThumbnail> s_uploads;
+static bool s_uploadScheduled = false;
+static bool s_decodePollScheduled = false;
+
+// Never destroyed: releasing textures during exit would outlive the GL context.
+static TextureCache& textures() {
+    static auto cache = new TextureCache(ttl::LruEviction<std::string>(THUMBNAIL_MEMORY_MAX));
+    return *cache;
+}
+
+static WorkQueue& decodeQueue() {
+    // Leaked so the worker is never joined during static destruction.
+    static auto queue = new WorkQueue(DECODE_THREADS, DECODE_QUEUE_MAX);
+    return *queue;
+}
+
+static DiskLru& diskCache() {
+    static DiskLru* lru = [] {
+        auto created = new DiskLru(Mod::get()->getSaveDir() / THUMBNAIL_DIR, THUMBNAIL_CACHE_BYTES);
+        created->scan();
+        return created;
+    }();
+    return *lru;
+}
+
+static void finishThumbnail(std::string const& id, CCTexture2D* texture) {
+    auto node = s_pending.extract(id);
+    if (node.empty()) return;
+    for (auto& callback : node.mapped().callbacks) callback(texture);
+}
+
+// Worker side. CCImage decodes without touching GL, which is what cocos's own
+// async texture loading relies on too.
+static RgbaImage decodeThumbnail(std::vector<uint8_t>& bytes) {
+    ScopedTimer timer(metrics::thumbnailDecodeDuration);
+    auto image = new CCImage();
+    RgbaImage out;
+    if (image->initWithImageData(bytes.data(), static_cast<int>(bytes.size()), CCImage::kFmtJpg)
+        && image->getBitsPerComponent() == 8) {
+        out = downscaleToRgba(
+            image->getData(), image->getWidth(), image->getHeight(), image->hasAlpha() ? 4 : 3, THUMBNAIL_WIDTH
+        );
+    }
+    image->release();
+    return out;
+}
+
+static void uploadThumbnail(DecodedThumbnail& decoded) {
+    ScopedTimer timer(metrics::thumbnailUploadDuration);
+    auto const& image = decoded.image;
+    auto texture = new CCTexture2D();
+    bool ok = texture->initWithData(
+        image.pixels.data(), kCCTexture2DPixelFormat_RGBA8888, image.width, image.height,
+        CCSize(static_cast<float>(image.width), static_cast<float>(image.height))
+    );
+    if (!ok) {
+        texture->release();
+        finishThumbnail(decoded.id, nullptr);
+        return;
+    }
+    texture->autorelease();
+    textures().store(decoded.id, Ref<CCTexture2D>(texture));
+    finishThumbnail(decoded.id, texture);
+}
+
+// A scheduler target that uploads decoded thumbnails within UPLOAD_BUDGET per
+// frame and unschedules itself once the queue is empty.
+class ThumbnailUploader : public CCObject {
+public:
+    void onFrame(float) {
+        auto start = std::chrono::steady_clock::now();
+        do {
+            auto decoded = std::move(s_uploads.front());
+            s_uploads.pop_front();
+            uploadThumbnail(decoded);
+        } while (!s_uploads.empty() && std::chrono::steady_clock::now() - start < UPLOAD_BUDGET);
+
+        if (s_uploads.empty()) {
+            CCScheduler::get()->unscheduleSelector(schedule_selector(ThumbnailUploader::onFrame), this);
+            s_uploadScheduled = false;
+        }
+    }
+};
+
+static void queueUpload(DecodedThumbnail decoded) {
+    s_uploads.push_back(std::move(decoded));
+    if (s_uploadScheduled) return;
+    // Lives as long as the game does.
+    static auto uploader = new ThumbnailUploader();
+    CCScheduler::get()->scheduleSelector(schedule_selector(ThumbnailUploader::onFrame), uploader, 0.f, false);
+    s_uploadScheduled = true;
+}
+
+static void onDecoded(DecodedThumbnail decoded) {
+    if (decoded.storedBytes) diskCache().add(decoded.id, *decoded.storedBytes);
+    if (decoded.image.pixels.empty()) {
+        log::debug("Failed to decode thumbnail {}", decoded.id);
+        // A cached file that no longer decodes is of no use to anyone.
+        if (!decoded.storedBytes) diskCache().remove(decoded.id);
+        finishThumbnail(decoded.id, nullptr);
+        return;
+    }
+    queueUpload(std::move(decoded));
+}
+
+// A scheduler target that hands finished decodes back to the main thread and
+// unschedules itself once none are left.
+class DecodePoller : public CCObject {
+public:
+    void onFrame(float) {
+        decodeQueue().poll();
+        if (decodeQueue().inFlight() == 0) {
+            CCScheduler::get()->unscheduleSelector(schedule_selector(DecodePoller::onFrame), this);
+            s_decodePollScheduled = false;
+        }
+    }
+};
+
+// Reads `path` unless `fetched` is given, decodes, and stores fetched bytes at
+// `path` when it's set. The worker only touches what it's handed.
+static void decodeOffThread(std::string id, std::filesystem::path path, std::optional<std::vector<uint8_t>> fetched) {
+    auto job = [id, path = std::move(path), fetched = std::move(fetched)]() mutable -> std::function<void()> {
+        std::vector<uint8_t> bytes;
+        if (fetched) {
+            bytes = std::move(*fetched);
+        }
+        else if (std::ifstream in(path, std::ios::binary); in) {
+            bytes.assign(std::istreambuf_iterator<char>(in), {});
+        }
+
+        DecodedThumbnail decoded{std::move(id), decodeThumbnail(bytes), std::nullopt};
+        if (fetched && !path.empty() && !decoded.image.pixels.empty()) {
+            FileSink sink(path);
+            sink += std::string_view(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+            if (sink.commit()) decoded.storedBytes = bytes.size();
+        }
+        return [decoded = std::move(decoded)]() mutable { onDecoded(std::move(decoded)); };
+    };
+    decodeQueue().push(std::move(job), [id] { finishThumbnail(id, nullptr); });
+
+    if (s_decodePollScheduled) return;
+    // Lives as long as the game does.
+    static auto poller = new DecodePoller();
+    CCScheduler::get()->scheduleSelector(schedule_selector(DecodePoller::onFrame), poller, 0.f, false);
+    s_decodePollScheduled = true;
+}
+
+static void fetchThumbnail(std::string const& id) {
+    auto url = youtubeThumbnailUrl(id);
+    s_pending[id].task.spawn(web::WebRequest().userAgent(USER_AGENT).get(url), [id](web::WebResponse res) {
+        noteNetworkActivity();
+        if (!res.ok()) {
+            log::debug("Thumbnail request for {} failed: {}", id, res.code());
+            // Not from inside the task's own callback, which finishing would destroy.
+            Loader::get()->queueInMainThread([id] { finishThumbnail(id, nullptr); });
+            return;
+        }
+        auto path = settings().disableCache ? std::filesystem::path() : diskCache().pathFor(id);
+        decodeOffThread(id, std::move(path), res.data());
+    });
+}
+
+void requestThumbnail(std::string const& videoUrl, ThumbnailCallback callback) {
+    auto id = youtubeVideoID(videoUrl);
+    if (!id) {
+        callback(nullptr);
+        return;
+    }
+
+    if (auto texture = textures().find(*id, 0)) {
+        metrics::thumbnailMemoryHits.add();
+        callback(*texture);
+        return;
+    }
+
+    auto [it, inserted] = s_pending.try_emplace(*id);
+    it->second.callbacks.push_back(std::move(callback));
+    if (!inserted) return;
+
+    if (!settings().disableCache && diskCache().touch(*id)) {
+        metrics::thumbnailDiskHits.add();
+        decodeOffThread(*id, diskCache().pathFor(*id), std::nullopt);
+        return;
+    }
+    if (settings().offlineMode) {
+        finishThumbnail(*id, nullptr);
+        return;
+    }
+    metrics::thumbnailMisses.add();
+    fetchThumbnail(*id);
+}
+
+void clearThumbnailMemory() {
+    textures().clear();
+}
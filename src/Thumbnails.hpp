@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Geode/Geode.hpp>
+
+#include <functional>
+#include <string>
+
+using ThumbnailCallback = std::function<void(cocos2d::CCTexture2D* texture)>;
+
+// Loads the thumbnail of a YouTube link. `callback` runs on the main thread
+// with the texture, or nullptr if the link has none or it couldn't be loaded.
+// Decoding happens on a single worker with a short queue; when it backs up,
+// the oldest waiting request gets nullptr. Repeat requests are served from
+// memory or the thumbnail directory without touching the network.
+void requestThumbnail(std::string const& videoUrl, ThumbnailCallback callback);
+// Drops the textures kept in memory; the thumbnail directory stays.
+void clearThumbnailMemory();
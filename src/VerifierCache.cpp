@@ -0,0 +1,265 @@
+#include "VerifierCache.hpp"
+#include "Changelog.hpp"
+#include "Common.hpp"
+#include "JsonBackend.hpp"
+#include "LevelEvents.hpp"
+#include "Metrics.hpp"
+#include "Settings.hpp"
+#include "core/CacheExpiry.hpp"
+#include "core/CacheFile.hpp"
+#include "core/LevelKey.hpp"
+#include "core/StagedCache.hpp"
+#include "core/TtlCache.hpp"
+
+#include <Geode/Geode.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace geode::prelude;
+
+// The cache file's JSON layout (see CacheFile.hpp), read through the
+// configured JSON backend.
+struct VerifierJsonCodec {
+    template <class Out>
+    static void writeBegin(Out& out) {
+        out += '{';
+    }
+    template <class Out>
+    static void writeEntry(Out& out, uint32_t key, VerifierData const& data, bool first) {
+        writeJsonCacheEntry(out, key, data, first);
+    }
+    template <class Out>
+    static void writeEnd(Out& out) {
+        out += '}';
+    }
+    template <class F>
+    static bool read(std::string_view text, F&& onEntry) {
+        return JsonBackend::parseCache(text, [&](std::string_view k, VerifierData data) {
+            if (auto key = parseLevelKey(k)) onEntry(*key, std::move(data));
+        });
+    }
+};
+
+// Expiry and the session cap depend on disable-cache, so both are read from
+// settings instead of being fixed in the type.
+struct VerifierExpiryState {
+    bool sessionOnly() const {
+        return settings().disableCache;
+    }
+    long long trackingSince() const {
+        return changelogTrackingSince();
+    }
+    std::span<long long const> lastPolls() const {
+        return changelogLastPolls();
+    }
+};
+
+using VerifierExpiry = CacheExpiry<VerifierExpiryState>;
+
+using VerifierStore = ttl::TtlCache<
+    uint32_t, VerifierData, VerifierJsonCodec,
+    ttl::OldestEviction<uint32_t>, VerifierExpiry, ttl::FilePersistence
+>;
+
+// The file is written hottest first. Loading parses the first HOT_ENTRIES
+// right away and the rest TAIL_SLICE per frame. Nothing waits for the tail:
+// lookups that miss meanwhile are published when their entry turns up, and
+// resolveLevel() holds its misses until the tail is in.
+static constexpr size_t HOT_ENTRIES = 256;
+static constexpr size_t TAIL_SLICE = 2048;
+// Completed fetches are folded into one save this long after the first.
+static constexpr float CACHE_SAVE_DELAY = 10.f;
+
+using VerifierStaged = StagedCache<VerifierStore>;
+
+static VerifierStaged s_store;
+// Keys that missed while the tail was loading.
+static std::unordered_set<uint32_t> s_missedWhileLoading;
+static std::vector<std::function<void()>> s_whenLoaded;
+// Parse time of the current load so far.
+static double s_loadSeconds = 0;
+static bool s_saveScheduled = false;
+
+static VerifierStore& cache() {
+    return s_store.cache();
+}
+
+static bool writeCacheFile() {
+    ScopedTimer timer(metrics::cacheSaveDuration);
+    if (s_store.save(nowSec())) return true;
+    log::error("Failed to save cache to {}", CACHE_FILE);
+    return false;
+}
+
+static void readTail(size_t limit) {
+    auto start = std::chrono::steady_clock::now();
+    auto state = s_store.readTail(limit, [](uint32_t key) {
+        if (s_missedWhileLoading.erase(key)) publishLevelUpdate(key);
+    });
+    s_loadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (state == VerifierStaged::TailState::Loading) return;
+
+    if (state == VerifierStaged::TailState::Malformed) {
+        log::warn("Cache file {} is malformed, keeping what could be read", CACHE_FILE);
+    }
+    metrics::cacheLoadDuration.observe(s_loadSeconds);
+    s_missedWhileLoading.clear();
+    for (auto& fn : std::exchange(s_whenLoaded, {})) fn();
+}
+
+// A scheduler target that reads the tail a slice per frame.
+class CacheTailLoader : public CCObject {
+public:
+    void onFrame(float) {
+        if (s_store.loading()) readTail(TAIL_SLICE);
+        if (!s_store.loading()) CCScheduler::get()->unscheduleSelector(schedule_selector(CacheTailLoader::onFrame), this);
+    }
+};
+
+static void readCacheFile() {
+#ifdef VERIFIER_JSON_MATJSON
+    // Only the streaming reader can stop partway, so matjson reads it all.
+    std::error_code ec;
+    if (!std::filesystem::exists(cache().persistence().path(), ec) || ec) return;
+    ScopedTimer timer(metrics::cacheLoadDuration);
+    if (!s_store.loadAll()) log::warn("Cache file {} is malformed, keeping what could be read", CACHE_FILE);
+#else
+    {
+        ScopedTimer timer(metrics::cacheHotLoadDuration);
+        if (!s_store.open()) return;
+        s_loadSeconds = 0;
+        readTail(HOT_ENTRIES);
+    }
+    if (!s_store.loading()) return;
+    // Deferred, since loadCache() runs before the scheduler is up.
+    Loader::get()->queueInMainThread([] {
+        // Lives as long as the game does.
+        static auto loader = new CacheTailLoader();
+        CCScheduler::get()->scheduleSelector(schedule_selector(CacheTailLoader::onFrame), loader, 0, false);
+    });
+#endif
+}
+
+static void hydrate() {
+    if (s_store.dehydrated()) readCacheFile();
+}
+
+// A scheduler target that saves the cache CACHE_SAVE_DELAY after
+// scheduleCacheSave().
+class CacheSaver : public CCObject {
+public:
+    void onSave(float) {
+        CCScheduler::get()->unscheduleSelector(schedule_selector(CacheSaver::onSave), this);
+        s_saveScheduled = false;
+        saveCache();
+    }
+};
+
+void saveCache() {
+    if (settings().disableCache || s_store.dehydrated() || !s_store.dirty()) return;
+    writeCacheFile();
+}
+
+void scheduleCacheSave() {
+    if (settings().disableCache || s_saveScheduled) return;
+    // Lives as long as the game does.
+    static auto saver = new CacheSaver();
+    CCScheduler::get()->scheduleSelector(schedule_selector(CacheSaver::onSave), saver, CACHE_SAVE_DELAY, false);
+    s_saveScheduled = true;
+}
+
+$on_mod(DataSaved) {
+    saveCache();
+}
+
+void loadCache() {
+    cache().persistence().setPath(Mod::get()->getSaveDir() / CACHE_FILE);
+    if (settings().disableCache) return;
+    readCacheFile();
+}
+
+void dehydrateCache(std::chrono::steady_clock::time_point deadline) {
+    if (settings().disableCache) {
+        cache().eraseExpired(nowSec());
+        return;
+    }
+    // Memory is only part of the file then, and lookups are waiting on the
+    // rest.
+    if (s_store.loading()) return;
+    // Only dropped once it is safely on disk.
+    if (!s_store.dehydrate(nowSec(), deadline)) {
+        log::warn("Keeping the cache in memory: saving it to {} failed or wouldn't finish in time", CACHE_FILE);
+    }
+}
+
+bool cacheLoading() {
+    return s_store.loading();
+}
+
+void whenCacheLoaded(std::function<void()> fn) {
+    if (!s_store.loading()) {
+        fn();
+        return;
+    }
+    s_whenLoaded.push_back(std::move(fn));
+}
+
+VerifierData const* findCached(uint32_t key) {
+    hydrate();
+    auto [data, status] = cache().lookup(key, nowSec());
+    if (status == ttl::Lookup::Miss && s_store.loading()) {
+        s_missedWhileLoading.insert(key);
+        return nullptr;
+    }
+    switch (status) {
+        case ttl::Lookup::Hit: metrics::cacheHits.add(); break;
+        case ttl::Lookup::Miss: metrics::cacheMisses.add(); break;
+        case ttl::Lookup::Stale: metrics::cacheStale.add(); break;
+    }
+    return data;
+}
+
+VerifierData const* findCachedAnyAge(uint32_t key) {
+    hydrate();
+    VerifierData const* data = cache().findAnyAge(key);
+    if (!data && s_store.loading()) s_missedWhileLoading.insert(key);
+    return data;
+}
+
+bool isCachedFresh(VerifierData const& data) {
+    return VerifierExpiry().isFresh(data, nowSec());
+}
+
+void recordAccess(uint32_t key) {
+    hydrate();
+    s_store.recordAccess(key, nowSec());
+}
+
+void storeCached(uint32_t key, VerifierData data) {
+    hydrate();
+    // Only the session cache is bounded; the setting can flip at runtime.
+    cache().eviction().setCapacity(settings().disableCache ? SESSION_CACHE_MAX : std::numeric_limits<size_t>::max());
+    if (auto evicted = s_store.store(key, std::move(data))) metrics::cacheEvictions.add(evicted);
+    s_missedWhileLoading.erase(key);
+    publishLevelUpdate(key);
+}
+
+// Sync is the only caller and starts from a button press, so waiting for the
+// rest of the file here is fine.
+void forEachCached(std::function<void(uint32_t key, VerifierData const& data)> const& fn) {
+    hydrate();
+    if (s_store.loading()) readTail(std::numeric_limits<size_t>::max());
+    cache().forEach(fn);
+}
+
+void invalidateCached(int levelID) {
+    hydrate();
+    s_store.erase(packLevelKey(levelID, false));
+    s_store.erase(packLevelKey(levelID, true));
+}
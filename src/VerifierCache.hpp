@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Common.hpp"
+#include "core/VerifierData.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+void loadCache();
+// Saves now if anything changed. Also runs when the game saves.
+void saveCache();
+// Saves within a few seconds; a burst of fetches costs one save.
+void scheduleCacheSave();
+// Saves if needed and then drops the in-memory cache, which is read back from
+// disk on next use. Skipped while the file is still loading, or if the last
+// save took longer than is left until `deadline`. With disable-cache on there
+// is no file, so only expired entries go.
+void dehydrateCache(std::chrono::steady_clock::time_point deadline);
+
+// Keys are packLevelKey() values; the cache file keeps the "<id>[_2p]" form.
+// Returns the entry for `key` if it is younger than CACHE_EXPIRY or the
+// changelog vouches for it, or nullptr. With disable-cache on, nothing is
+// read from or written to disk, and entries are reused only for
+// SESSION_CACHE_EXPIRY, at most SESSION_CACHE_MAX of them.
+//
+// Right after a load only the hottest entries are in memory while the rest
+// of the file is read over the next frames. Until cacheLoading() is false,
+// a miss may just be early: keys that missed are published (LevelEvents.hpp)
+// if their entry turns up, and whenCacheLoaded() runs `fn` once it's all in,
+// right away if it already is.
+VerifierData const* findCached(uint32_t key);
+VerifierData const* findCachedAnyAge(uint32_t key);
+// Whether findCached() would return `data`, without counting a lookup.
+bool isCachedFresh(VerifierData const& data);
+bool cacheLoading();
+void whenCacheLoaded(std::function<void()> fn);
+// Counts an interactive use of `key`. The hottest entries are saved first and
+// are usable right after launch while the rest of the file loads.
+void recordAccess(uint32_t key);
+// Subscribers of `key` are notified on the next frame (see LevelEvents.hpp).
+void storeCached(uint32_t key, VerifierData data);
+// Reads the rest of the file first if it is still loading.
+void forEachCached(std::function<void(uint32_t key, VerifierData const& data)> const& fn);
+// Drops both the solo and 2P entries of a level.
+void invalidateCached(int levelID);
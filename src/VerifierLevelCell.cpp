@@ -0,0 +1,78 @@
+#include <Geode/Geode.hpp>
+#include <Geode/modify/LevelCell.hpp>
+
+#include "BadgeCache.hpp"
+#include "LevelEvents.hpp"
+#include "ListFilter.hpp"
+#include "Settings.hpp"
+#include "VerifierCache.hpp"
+#include "core/LevelKey.hpp"
+#include "core/VerifierLabel.hpp"
+
+using namespace geode::prelude;
+
+static constexpr float BADGE_MAX_WIDTH = 150.f;
+
+class $modify(VerifierLevelCell, LevelCell) {
+    struct Fields {
+        LevelSubscription m_updates;
+    };
+
+    // Cells only show what is already cached; scrolling a list never fetches,
+    // but a badge appears as soon as something else caches the level.
+    void loadFromLevel(GJGameLevel* level) {
+        LevelCell::loadFromLevel(level);
+
+        m_fields->m_updates = {};
+        updateDimming(level);
+        updateBadge(level);
+        if (!settings().showLabel || !settings().showInLists) return;
+        if (!level || level->m_levelID <= 0 || level->m_demonDifficulty < 5) return;
+
+        m_fields->m_updates = subscribeLevels({packLevelKey(static_cast<int>(level->m_levelID), false)}, [this](uint32_t) {
+            updateBadge(m_level);
+        });
+    }
+
+    void updateDimming(GJGameLevel* level) {
+        if (auto old = m_mainLayer->getChildByID("verifier-dim"_spr)) old->removeFromParent();
+        if (settings().listFilter != ListFilter::Gray) return;
+        if (!level || levelMembership(level) != Membership::Unlisted) return;
+
+        auto dim = CCLayerColor::create({0, 0, 0, 110}, m_width, m_height);
+        dim->setID("verifier-dim"_spr);
+        dim->setZOrder(100);
+        m_mainLayer->addChild(dim);
+    }
+
+    void updateBadge(GJGameLevel* level) {
+        if (auto old = m_mainLayer->getChildByID("verifier-badge"_spr)) old->removeFromParent();
+        if (!settings().showLabel) return;
+        if (!settings().showInLists) return;
+        if (!level || level->m_levelID <= 0 || level->m_demonDifficulty < 5) return;
+
+        auto d = findCached(packLevelKey(static_cast<int>(level->m_levelID), false));
+        if (!d || d->verifier.empty()) return;
+        if (level->m_demonDifficulty == 5 && !d->legacy) return;
+
+        // The cell shows the solo entry, so a 2P level's badge says so, as the
+        // level page does.
+        VerifierLabel text;
+        formatVerifierLabel(text, d->verifier, false, level->m_twoPlayerMode);
+
+        bool grayed = d->legacy && settings().legacyColor;
+        auto badge = createBadgeSprite(
+            text.data(),
+            grayed ? "bigFont.fnt" : "goldFont.fnt",
+            grayed ? 0.3f : 0.35f
+        );
+        if (!badge) return;
+
+        auto width = badge->getContentSize().width;
+        if (width > BADGE_MAX_WIDTH) badge->setScale(BADGE_MAX_WIDTH / width);
+        badge->setAnchorPoint({1, 0});
+        badge->setPosition({m_width - 8.f, 4.f});
+        badge->setID("verifier-badge"_spr);
+        m_mainLayer->addChild(badge);
+    }
+};
@@ -0,0 +1,627 @@
+#include "AsyncIo.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && !defined(__ANDROID__) && __has_include(<linux/io_uring.h>)
+#define VERIFIER_IO_URING 1
+#include <atomic>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// Largest single read or write handed to the OS; bigger transfers loop.
+static constexpr size_t MAX_TRANSFER = 1 << 30;
+
+void AsyncIo::enqueue(std::unique_ptr<Op> op) {
+    m_queued.push_back(std::move(op));
+    ++m_inFlight;
+}
+
+void AsyncIo::read(std::filesystem::path path, IoCallback done) {
+    auto op = std::make_unique<Op>();
+    op->kind = Op::Kind::Read;
+    op->path = std::move(path);
+    op->done = std::move(done);
+    enqueue(std::move(op));
+}
+
+void AsyncIo::write(std::filesystem::path path, std::vector<uint8_t> data, WriteMode mode, bool sync, IoCallback done) {
+    auto op = std::make_unique<Op>();
+    op->kind = Op::Kind::Write;
+    op->path = std::move(path);
+    op->data = std::move(data);
+    op->mode = mode;
+    op->sync = sync;
+    op->done = std::move(done);
+    enqueue(std::move(op));
+}
+
+void AsyncIo::rename(std::filesystem::path from, std::filesystem::path to, IoCallback done) {
+    auto op = std::make_unique<Op>();
+    op->kind = Op::Kind::Rename;
+    op->path = std::move(from);
+    op->target = std::move(to);
+    op->done = std::move(done);
+    enqueue(std::move(op));
+}
+
+void AsyncIo::replace(std::filesystem::path path, std::vector<uint8_t> data, IoCallback done) {
+    auto it = m_replaces.find(path.string());
+    if (it == m_replaces.end()) {
+        std::vector<IoCallback> callbacks;
+        callbacks.push_back(std::move(done));
+        startReplace(path, std::move(data), std::move(callbacks));
+        return;
+    }
+    // Whatever was waiting is superseded; it never reaches the disk.
+    it->second.next = std::move(data);
+    it->second.waiting.push_back(std::move(done));
+}
+
+void AsyncIo::startReplace(std::filesystem::path const& path, std::vector<uint8_t> data, std::vector<IoCallback> callbacks) {
+    m_replaces[path.string()] = {};
+    auto temp = path;
+    temp += ".tmp";
+    write(temp, std::move(data), WriteMode::Truncate, true, [this, path, temp, callbacks = std::move(callbacks)](IoResult res) {
+        if (!res.ok) {
+            std::error_code ec;
+            std::filesystem::remove(temp, ec);
+            finishReplace(path, res, callbacks);
+            return;
+        }
+        rename(temp, path, [this, path, callbacks](IoResult renamed) {
+            finishReplace(path, renamed, callbacks);
+        });
+    });
+}
+
+void AsyncIo::finishReplace(std::filesystem::path const& path, IoResult const& result, std::vector<IoCallback> const& callbacks) {
+    for (auto const& callback : callbacks) {
+        if (callback) callback(result);
+    }
+    // Looked up after the callbacks, which may have queued another replace.
+    auto it = m_replaces.find(path.string());
+    if (it == m_replaces.end()) return;
+    if (!it->second.next) {
+        m_replaces.erase(it);
+        return;
+    }
+    auto data = std::move(*it->second.next);
+    auto waiting = std::move(it->second.waiting);
+    startReplace(path, std::move(data), std::move(waiting));
+}
+
+void AsyncIo::submit() {
+    if (m_queued.empty()) return;
+    issue(std::exchange(m_queued, {}));
+}
+
+void AsyncIo::finish(std::unique_ptr<Op> op) {
+    {
+        std::lock_guard lock(m_finishedLock);
+        m_finished.push_back(std::move(op));
+    }
+    m_finishedSignal.notify_one();
+}
+
+bool AsyncIo::hasFinished() {
+    std::lock_guard lock(m_finishedLock);
+    return !m_finished.empty();
+}
+
+void AsyncIo::waitForFinished(std::chrono::steady_clock::time_point until) {
+    std::unique_lock lock(m_finishedLock);
+    auto finished = [this] { return !m_finished.empty(); };
+    // Not every wait_until() copes with time_point::max().
+    if (until == std::chrono::steady_clock::time_point::max()) m_finishedSignal.wait(lock, finished);
+    else m_finishedSignal.wait_until(lock, until, finished);
+}
+
+size_t AsyncIo::poll() {
+    submit();
+    reap(std::chrono::steady_clock::time_point::min());
+
+    std::vector<std::unique_ptr<Op>> finished;
+    {
+        std::lock_guard lock(m_finishedLock);
+        finished.swap(m_finished);
+    }
+    for (auto& op : finished) {
+        --m_inFlight;
+        if (op->done) op->done(std::move(op->result));
+    }
+    submit();
+    return finished.size();
+}
+
+void AsyncIo::drain() {
+    drainUntil(std::chrono::steady_clock::time_point::max());
+}
+
+bool AsyncIo::drainUntil(std::chrono::steady_clock::time_point deadline) {
+    while (m_inFlight > 0) {
+        submit();
+        reap(deadline);
+        poll();
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+    return m_inFlight == 0;
+}
+
+IoResult blockingRead(std::filesystem::path const& path) {
+    IoResult out;
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return out;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size)) {
+        out.data.resize(static_cast<size_t>(size.QuadPart));
+        size_t done = 0;
+        DWORD n = 0;
+        while (done < out.data.size()) {
+            auto chunk = static_cast<DWORD>(std::min(out.data.size() - done, MAX_TRANSFER));
+            if (!ReadFile(file, out.data.data() + done, chunk, &n, nullptr) || n == 0) break;
+            done += n;
+        }
+        out.data.resize(done);
+        out.ok = done == static_cast<size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return out;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        out.data.resize(static_cast<size_t>(st.st_size));
+        size_t done = 0;
+        while (done < out.data.size()) {
+            auto n = ::read(fd, out.data.data() + done, std::min(out.data.size() - done, MAX_TRANSFER));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            done += static_cast<size_t>(n);
+        }
+        // A file that shrank under us still reads as what was there.
+        out.data.resize(done);
+        out.ok = true;
+    }
+    ::close(fd);
+#endif
+    return out;
+}
+
+IoResult blockingWrite(std::filesystem::path const& path, std::span<uint8_t const> data, WriteMode mode, bool sync) {
+    IoResult out;
+#ifdef _WIN32
+    DWORD disposition = mode == WriteMode::Append ? OPEN_ALWAYS : CREATE_ALWAYS;
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return out;
+    // FlushFileBuffers needs GENERIC_WRITE, which rules out FILE_APPEND_DATA.
+    if (mode == WriteMode::Append && !SetFilePointerEx(file, {}, nullptr, FILE_END)) {
+        CloseHandle(file);
+        return out;
+    }
+    size_t done = 0;
+    DWORD n = 0;
+    while (done < data.size()) {
+        auto chunk = static_cast<DWORD>(std::min(data.size() - done, MAX_TRANSFER));
+        if (!WriteFile(file, data.data() + done, chunk, &n, nullptr)) break;
+        done += n;
+    }
+    out.ok = done == data.size() && (!sync || FlushFileBuffers(file));
+    CloseHandle(file);
+#else
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (mode == WriteMode::Append ? O_APPEND : O_TRUNC);
+    int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) return out;
+    size_t done = 0;
+    while (done < data.size()) {
+        auto n = ::write(fd, data.data() + done, std::min(data.size() - done, MAX_TRANSFER));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    out.ok = done == data.size() && (!sync || fsync(fd) == 0);
+    if (::close(fd) != 0) out.ok = false;
+#endif
+    return out;
+}
+
+IoResult blockingRename(std::filesystem::path const& from, std::filesystem::path const& to) {
+    std::error_code ec;
+    std::filesystem::rename(from, to, ec);
+    IoResult out;
+    out.ok = !ec;
+    return out;
+}
+
+IoResult blockingSync(std::filesystem::path const& path) {
+    IoResult out;
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return out;
+    out.ok = FlushFileBuffers(file);
+    CloseHandle(file);
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return out;
+    out.ok = fsync(fd) == 0;
+    if (::close(fd) != 0) out.ok = false;
+#endif
+    return out;
+}
+
+// Workers pulling ops off a shared queue and running the blocking calls.
+class ThreadPoolIo final : public AsyncIo {
+public:
+    explicit ThreadPoolIo(size_t threads) {
+        for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+            m_workers.emplace_back([this] { work(); });
+        }
+    }
+
+    ~ThreadPoolIo() override {
+        {
+            std::lock_guard lock(m_lock);
+            m_stopping = true;
+        }
+        m_signal.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    char const* name() const override {
+        return "threads";
+    }
+
+protected:
+    void issue(std::vector<std::unique_ptr<Op>> batch) override {
+        {
+            std::lock_guard lock(m_lock);
+            for (auto& op : batch) m_pending.push_back(std::move(op));
+        }
+        m_signal.notify_all();
+    }
+
+    void reap(std::chrono::steady_clock::time_point until) override {
+        waitForFinished(until);
+    }
+
+private:
+    void work() {
+        while (true) {
+            std::unique_ptr<Op> op;
+            {
+                std::unique_lock lock(m_lock);
+                m_signal.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+                if (m_stopping) return;
+                op = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+            switch (op->kind) {
+                case Op::Kind::Read: op->result = blockingRead(op->path); break;
+                case Op::Kind::Write: op->result = blockingWrite(op->path, op->data, op->mode, op->sync); break;
+                case Op::Kind::Rename: op->result = blockingRename(op->path, op->target); break;
+            }
+            op->data.clear();
+            op->data.shrink_to_fit();
+            finish(std::move(op));
+        }
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_signal;
+    std::deque<std::unique_ptr<Op>> m_pending;
+    std::vector<std::thread> m_workers;
+    bool m_stopping = false;
+};
+
+std::unique_ptr<AsyncIo> makeThreadPoolIo(size_t threads) {
+    return std::make_unique<ThreadPoolIo>(threads);
+}
+
+#ifdef VERIFIER_IO_URING
+
+// One submission/completion ring, driven by raw syscalls so there's no
+// liburing dependency. Files are opened and closed synchronously (both are
+// cheap next to the transfer); reads, writes, fsyncs and renames go through
+// the ring. Everything runs on the polling thread, so no locking beyond what
+// finish() does.
+class IoUringIo final : public AsyncIo {
+public:
+    static std::unique_ptr<IoUringIo> create(unsigned entries) {
+        auto io = std::unique_ptr<IoUringIo>(new IoUringIo());
+        return io->setup(entries) ? std::move(io) : nullptr;
+    }
+
+    ~IoUringIo() override {
+        if (m_ring < 0) return;
+        // The kernel still holds pointers into pending ops; let them land.
+        while (m_inKernel > 0) {
+            enter(0, 1, IORING_ENTER_GETEVENTS);
+            completeAll();
+            m_backlog.clear();
+        }
+        if (m_sqes) munmap(m_sqes, m_sqesSize);
+        if (m_cqMap && m_cqMap != m_sqMap) munmap(m_cqMap, m_cqMapSize);
+        if (m_sqMap) munmap(m_sqMap, m_sqMapSize);
+        ::close(m_ring);
+    }
+
+    char const* name() const override {
+        return "io_uring";
+    }
+
+protected:
+    void issue(std::vector<std::unique_ptr<Op>> batch) override {
+        for (auto& op : batch) start(std::move(op));
+        flush();
+    }
+
+    void reap(std::chrono::steady_clock::time_point until) override {
+        while (true) {
+            completeAll();
+            flush();
+            if (hasFinished() || m_inKernel == 0) return;
+            auto now = std::chrono::steady_clock::now();
+            if (now >= until) return;
+            if (until == std::chrono::steady_clock::time_point::max()) {
+                enter(0, 1, IORING_ENTER_GETEVENTS);
+                continue;
+            }
+            if (!m_timedWaits) {
+                // Kernels before 5.11 can't bound the wait; check back shortly.
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - now, std::chrono::milliseconds(1)));
+                continue;
+            }
+            auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(until - now).count();
+            __kernel_timespec timeout{left / 1'000'000'000, left % 1'000'000'000};
+            io_uring_getevents_arg arg{};
+            arg.ts = reinterpret_cast<uint64_t>(&timeout);
+            enter(0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg);
+        }
+    }
+
+private:
+    struct Pending {
+        std::unique_ptr<Op> op;
+        int fd = -1;
+        size_t done = 0;
+        bool syncing = false;
+    };
+
+    IoUringIo() = default;
+
+    bool setup(unsigned entries) {
+        io_uring_params params{};
+        m_ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (m_ring < 0) return false;
+        m_timedWaits = params.features & IORING_FEAT_EXT_ARG;
+
+        m_sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) m_sqMapSize = m_cqMapSize = std::max(m_sqMapSize, m_cqMapSize);
+
+        m_sqMap = mmap(nullptr, m_sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+        if (m_sqMap == MAP_FAILED) {
+            m_sqMap = nullptr;
+            return false;
+        }
+        m_cqMap = single ? m_sqMap
+            : mmap(nullptr, m_cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+        if (m_cqMap == MAP_FAILED) {
+            m_cqMap = nullptr;
+            return false;
+        }
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+        auto sq = static_cast<char*>(m_sqMap);
+        m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        m_sqEntries = params.sq_entries;
+
+        auto cq = static_cast<char*>(m_cqMap);
+        m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    int enter(unsigned submit, unsigned minComplete, unsigned flags, io_uring_getevents_arg* arg = nullptr) {
+        size_t argSize = arg ? sizeof(*arg) : 0;
+        int res;
+        do {
+            res = static_cast<int>(syscall(__NR_io_uring_enter, m_ring, submit, minComplete, flags, arg, argSize));
+        } while (res < 0 && errno == EINTR);
+        return res;
+    }
+
+    void fail(std::unique_ptr<Pending> p) {
+        if (p->fd >= 0) ::close(p->fd);
+        p->op->result.ok = false;
+        p->op->result.data.clear();
+        finish(std::move(p->op));
+    }
+
+    void succeed(std::unique_ptr<Pending> p) {
+        if (p->fd >= 0 && ::close(p->fd) != 0) {
+            fail(std::move(p));
+            return;
+        }
+        p->op->result.ok = true;
+        if (p->op->kind == Op::Kind::Read) {
+            p->op->data.resize(p->done);
+            p->op->result.data = std::move(p->op->data);
+        }
+        else {
+            p->op->data.clear();
+            p->op->data.shrink_to_fit();
+        }
+        finish(std::move(p->op));
+    }
+
+    void start(std::unique_ptr<Op> op) {
+        auto p = std::make_unique<Pending>();
+        p->op = std::move(op);
+        auto& o = *p->op;
+        if (o.kind == Op::Kind::Read) {
+            p->fd = ::open(o.path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st;
+            if (p->fd < 0 || fstat(p->fd, &st) != 0) return fail(std::move(p));
+            o.data.resize(static_cast<size_t>(st.st_size));
+            if (o.data.empty()) return succeed(std::move(p));
+        }
+        else if (o.kind == Op::Kind::Write) {
+            int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (o.mode == WriteMode::Append ? O_APPEND : O_TRUNC);
+            p->fd = ::open(o.path.c_str(), flags, 0644);
+            if (p->fd < 0) return fail(std::move(p));
+            if (o.data.empty() && !o.sync) return succeed(std::move(p));
+            p->syncing = o.data.empty();
+        }
+        m_backlog.push_back(std::move(p));
+    }
+
+    // Moves backlog into free submission slots and tells the kernel. Ops in
+    // the kernel never exceed the SQ size, which keeps the CQ (twice as big)
+    // from overflowing.
+    void flush() {
+        unsigned tail = *m_sqTail;
+        unsigned added = 0;
+        while (!m_backlog.empty() && m_inKernel < m_sqEntries) {
+            auto p = std::move(m_backlog.front());
+            m_backlog.pop_front();
+            unsigned index = tail & m_sqMask;
+            prepare(m_sqes[index], *p);
+            m_sqArray[index] = index;
+            ++tail;
+            ++added;
+            ++m_inKernel;
+            p.release();
+        }
+        if (added == 0) return;
+        std::atomic_ref(*m_sqTail).store(tail, std::memory_order_release);
+        enter(added, 0, 0);
+    }
+
+    static void prepare(io_uring_sqe& sqe, Pending& p) {
+        sqe = {};
+        sqe.user_data = reinterpret_cast<uint64_t>(&p);
+        auto& o = *p.op;
+        if (o.kind == Op::Kind::Rename) {
+            sqe.opcode = IORING_OP_RENAMEAT;
+            sqe.fd = AT_FDCWD;
+            sqe.addr = reinterpret_cast<uint64_t>(o.path.c_str());
+            sqe.len = static_cast<uint32_t>(AT_FDCWD);
+            sqe.addr2 = reinterpret_cast<uint64_t>(o.target.c_str());
+            return;
+        }
+        sqe.fd = p.fd;
+        if (p.syncing) {
+            sqe.opcode = IORING_OP_FSYNC;
+            return;
+        }
+        sqe.opcode = o.kind == Op::Kind::Read ? IORING_OP_READ : IORING_OP_WRITE;
+        sqe.addr = reinterpret_cast<uint64_t>(o.data.data() + p.done);
+        sqe.len = static_cast<uint32_t>(std::min(o.data.size() - p.done, MAX_TRANSFER));
+        // Appends ignore the offset; O_APPEND puts them at the end.
+        sqe.off = p.done;
+    }
+
+    void completeAll() {
+        unsigned head = *m_cqHead;
+        unsigned tail = std::atomic_ref(*m_cqTail).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            auto& cqe = m_cqes[head & m_cqMask];
+            std::unique_ptr<Pending> p(reinterpret_cast<Pending*>(cqe.user_data));
+            --m_inKernel;
+            complete(std::move(p), cqe.res);
+        }
+        std::atomic_ref(*m_cqHead).store(head, std::memory_order_release);
+    }
+
+    void complete(std::unique_ptr<Pending> p, int res) {
+        auto& o = *p->op;
+        if (o.kind == Op::Kind::Rename) {
+            // Kernels before 5.11 don't know the opcode.
+            if (res == -EINVAL) {
+                o.result = blockingRename(o.path, o.target);
+                finish(std::move(p->op));
+            }
+            else if (res < 0) fail(std::move(p));
+            else succeed(std::move(p));
+            return;
+        }
+        if (res == -EINTR || res == -EAGAIN) {
+            m_backlog.push_back(std::move(p));
+            return;
+        }
+        if (res < 0) return fail(std::move(p));
+        if (p->syncing) return succeed(std::move(p));
+
+        p->done += static_cast<size_t>(res);
+        bool eof = o.kind == Op::Kind::Read && res == 0;
+        if (o.kind == Op::Kind::Write && res == 0) return fail(std::move(p));
+        if (p->done < o.data.size() && !eof) {
+            // Short transfer: go again for the rest.
+            m_backlog.push_back(std::move(p));
+            return;
+        }
+        if (o.kind == Op::Kind::Write && o.sync) {
+            p->syncing = true;
+            m_backlog.push_back(std::move(p));
+            return;
+        }
+        succeed(std::move(p));
+    }
+
+    int m_ring = -1;
+    void* m_sqMap = nullptr;
+    void* m_cqMap = nullptr;
+    size_t m_sqMapSize = 0;
+    size_t m_cqMapSize = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+    unsigned* m_sqTail = nullptr;
+    unsigned* m_sqArray = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe* m_cqes = nullptr;
+    unsigned m_inKernel = 0;
+    bool m_timedWaits = false;
+    std::deque<std::unique_ptr<Pending>> m_backlog;
+};
+
+std::unique_ptr<AsyncIo> makeIoUringIo(unsigned entries) {
+    return IoUringIo::create(entries);
+}
+
+#else
+
+std::unique_ptr<AsyncIo> makeIoUringIo(unsigned) {
+    return nullptr;
+}
+
+#endif
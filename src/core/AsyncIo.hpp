@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct IoResult {
+    bool ok = false;
+    std::vector<uint8_t> data; // reads only
+};
+
+using IoCallback = std::function<void(IoResult)>;
+
+enum class WriteMode { Truncate, Append };
+
+// Non-blocking file operations for the persistence layer. Calls only queue
+// work; submit() hands everything queued to the backend as one batch, and
+// poll() runs the callbacks of finished operations on the calling thread, so
+// callbacks never race their caller. Not thread-safe itself: one thread owns
+// the queue and polls it.
+class AsyncIo {
+public:
+    virtual ~AsyncIo() = default;
+    virtual char const* name() const = 0;
+
+    void read(std::filesystem::path path, IoCallback done);
+    // With `sync`, the data is on disk (fsync) before `done` runs.
+    void write(std::filesystem::path path, std::vector<uint8_t> data, WriteMode mode, bool sync, IoCallback done);
+    void rename(std::filesystem::path from, std::filesystem::path to, IoCallback done);
+    // Durable atomic replace: writes and fsyncs "<path>.tmp", then renames it
+    // over `path`. Replaces of one path apply in call order; the ones queued
+    // while another is in flight collapse into the newest, and all of their
+    // callbacks get its result.
+    void replace(std::filesystem::path path, std::vector<uint8_t> data, IoCallback done);
+
+    void submit();
+    // Runs finished callbacks (and submits what they queued). Returns how
+    // many ran.
+    size_t poll();
+    // Submits and waits until nothing is left in flight, running callbacks.
+    void drain();
+    // drain() that gives up at `deadline`. True if everything finished.
+    bool drainUntil(std::chrono::steady_clock::time_point deadline);
+    // Operations queued or running whose callbacks haven't run yet.
+    size_t inFlight() const {
+        return m_inFlight;
+    }
+
+protected:
+    struct Op {
+        enum class Kind { Read, Write, Rename } kind;
+        std::filesystem::path path;
+        std::filesystem::path target; // rename only
+        std::vector<uint8_t> data;
+        WriteMode mode = WriteMode::Truncate;
+        bool sync = false;
+        IoResult result;
+        IoCallback done;
+    };
+
+    // Starts a batch; every op comes back through finish(), from any thread.
+    virtual void issue(std::vector<std::unique_ptr<Op>> batch) = 0;
+    // Collects completions, blocking until hasFinished(), nothing is left in
+    // the backend, or `until` passes. time_point::min() never blocks.
+    virtual void reap(std::chrono::steady_clock::time_point until) = 0;
+
+    void finish(std::unique_ptr<Op> op);
+    // Whether an op has finished since the last poll().
+    bool hasFinished();
+    // For backends whose ops finish on other threads.
+    void waitForFinished(std::chrono::steady_clock::time_point until);
+
+private:
+    struct ReplaceState {
+        std::optional<std::vector<uint8_t>> next;
+        std::vector<IoCallback> waiting;
+    };
+
+    void enqueue(std::unique_ptr<Op> op);
+    void startReplace(std::filesystem::path const& path, std::vector<uint8_t> data, std::vector<IoCallback> callbacks);
+    void finishReplace(std::filesystem::path const& path, IoResult const& result, std::vector<IoCallback> const& callbacks);
+
+    std::vector<std::unique_ptr<Op>> m_queued;
+    std::mutex m_finishedLock;
+    std::condition_variable m_finishedSignal;
+    std::vector<std::unique_ptr<Op>> m_finished;
+    size_t m_inFlight = 0;
+    // Paths with a replace in flight.
+    std::unordered_map<std::string, ReplaceState> m_replaces;
+};
+
+// `threads` workers running the blocking calls below. Destroying it joins
+// the workers; ops not yet started are dropped without callbacks.
+std::unique_ptr<AsyncIo> makeThreadPoolIo(size_t threads);
+// io_uring on desktop Linux; nullptr elsewhere or if the kernel refuses it.
+std::unique_ptr<AsyncIo> makeIoUringIo(unsigned entries = 64);
+
+// The blocking primitives behind the thread pool, also the baseline the
+// benchmarks compare against.
+IoResult blockingRead(std::filesystem::path const& path);
+IoResult blockingWrite(std::filesystem::path const& path, std::span<uint8_t const> data, WriteMode mode, bool sync);
+IoResult blockingRename(std::filesystem::path const& from, std::filesystem::path const& to);
+// fsync for a file written through something without a descriptor to hand.
+IoResult blockingSync(std::filesystem::path const& path);
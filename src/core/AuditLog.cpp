@@ -0,0 +1,70 @@
+#include "AuditLog.hpp"
+
+#include <cstring>
+
+std::vector<uint8_t> AuditRing::serialize() const {
+    AuditHeader header{AUDIT_MAGIC, AUDIT_VERSION, sizeof(AuditRecord), static_cast<uint32_t>(m_count)};
+    std::vector<uint8_t> out(sizeof(header) + m_count * sizeof(AuditRecord));
+    std::memcpy(out.data(), &header, sizeof(header));
+    auto dst = out.data() + sizeof(header);
+    forEach([&](AuditRecord const& record) {
+        std::memcpy(dst, &record, sizeof(record));
+        dst += sizeof(record);
+    });
+    return out;
+}
+
+std::optional<AuditRing> AuditRing::deserialize(std::span<uint8_t const> bytes, size_t capacity) {
+    AuditHeader header;
+    if (capacity == 0 || bytes.size() < sizeof(header)) return std::nullopt;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != AUDIT_MAGIC || header.version != AUDIT_VERSION) return std::nullopt;
+    if (header.recordBytes != sizeof(AuditRecord)) return std::nullopt;
+    if (bytes.size() != sizeof(header) + size_t(header.count) * sizeof(AuditRecord)) return std::nullopt;
+
+    AuditRing ring(capacity);
+    auto src = bytes.data() + sizeof(header);
+    for (uint32_t i = 0; i < header.count; ++i, src += sizeof(AuditRecord)) {
+        AuditRecord record;
+        std::memcpy(&record, src, sizeof(record));
+        ring.push(record);
+    }
+    return ring;
+}
+
+char const* auditDecisionName(AuditDecision decision) {
+    switch (decision) {
+        case AuditDecision::CacheHit: return "cache-hit";
+        case AuditDecision::LocalUnlisted: return "local-unlisted";
+        case AuditDecision::Joined: return "joined";
+        case AuditDecision::Queued: return "queued";
+        case AuditDecision::Dispatched: return "dispatched";
+        case AuditDecision::Completed: return "completed";
+        case AuditDecision::Requeued: return "requeued";
+        case AuditDecision::RecentFailure: return "recent-failure";
+    }
+    return "unknown";
+}
+
+char const* auditReasonName(AuditReason reason) {
+    switch (reason) {
+        case AuditReason::None: return "none";
+        case AuditReason::Miss: return "miss";
+        case AuditReason::Expired: return "expired";
+        case AuditReason::Retry: return "retry";
+    }
+    return "unknown";
+}
+
+char const* auditOutcomeName(AuditOutcome outcome) {
+    switch (outcome) {
+        case AuditOutcome::Pending: return "pending";
+        case AuditOutcome::Ok: return "ok";
+        case AuditOutcome::NotFound: return "not-found";
+        case AuditOutcome::RateLimited: return "rate-limited";
+        case AuditOutcome::ServerError: return "server-error";
+        case AuditOutcome::Failed: return "failed";
+        case AuditOutcome::ParseError: return "parse-error";
+    }
+    return "unknown";
+}
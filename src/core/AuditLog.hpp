@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Fixed-size records of what the request path decided for a key and why, kept
+// in a ring so the log never grows past its capacity.
+//
+// On disk, little-endian: AuditHeader, then `count` AuditRecords oldest first.
+
+static constexpr uint32_t AUDIT_MAGIC = 0x31414c56; // "VLA1"
+static constexpr uint32_t AUDIT_VERSION = 1;
+
+enum class AuditDecision : uint8_t {
+    CacheHit,      // served from a valid entry
+    LocalUnlisted, // the level sets settled it without a request
+    Joined,        // attached to a request already pending
+    Queued,        // a new request was queued
+    Dispatched,    // a queued request was sent
+    Completed,     // a response was handled
+    Requeued,      // a response sent the request back to the queue
+    RecentFailure, // a fetch just failed, so none was made
+};
+
+enum class AuditReason : uint8_t {
+    None,
+    Miss,    // no entry at all
+    Expired, // an entry too old to serve
+    Retry,   // a previous attempt was rate limited
+};
+
+enum class AuditOutcome : uint8_t {
+    Pending,
+    Ok,
+    NotFound,
+    RateLimited,
+    ServerError,
+    Failed,
+    ParseError,
+};
+
+struct AuditRecord {
+    uint32_t time;     // unix seconds
+    uint32_t key;      // packLevelKey()
+    uint32_t entryAge; // seconds, AUDIT_NO_ENTRY if nothing was cached
+    AuditDecision decision;
+    AuditReason reason;
+    uint8_t background;
+    AuditOutcome outcome;
+};
+
+static constexpr uint32_t AUDIT_NO_ENTRY = 0xffffffff;
+
+struct AuditHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordBytes;
+    uint32_t count;
+};
+
+static_assert(sizeof(AuditRecord) == 16);
+static_assert(sizeof(AuditHeader) == 16);
+
+class AuditRing {
+public:
+    explicit AuditRing(size_t capacity) : m_records(capacity) {}
+
+    // Overwrites the oldest record once full.
+    void push(AuditRecord const& record) {
+        m_records[m_head] = record;
+        m_head = (m_head + 1) % m_records.size();
+        if (m_count < m_records.size()) ++m_count;
+    }
+
+    size_t size() const {
+        return m_count;
+    }
+
+    // Oldest first.
+    template <class F>
+    void forEach(F&& fn) const {
+        size_t start = (m_head + m_records.size() - m_count) % m_records.size();
+        for (size_t i = 0; i < m_count; ++i) fn(m_records[(start + i) % m_records.size()]);
+    }
+
+    std::vector<uint8_t> serialize() const;
+    // Keeps the newest records if the file holds more than `capacity`.
+    static std::optional<AuditRing> deserialize(std::span<uint8_t const> bytes, size_t capacity);
+
+private:
+    std::vector<AuditRecord> m_records;
+    size_t m_head = 0;
+    size_t m_count = 0;
+};
+
+char const* auditDecisionName(AuditDecision decision);
+char const* auditReasonName(AuditReason reason);
+char const* auditOutcomeName(AuditOutcome outcome);
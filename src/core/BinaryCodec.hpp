@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Schema.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Compact binary encoding generated from a Schema. A record is a field count
+// followed by one tagged value per field, in declaration order:
+//   tag 0: LEB128 varint (bools, zigzag-encoded integers)
+//   tag 1: varint length + bytes (strings)
+// Decoders skip trailing fields they don't know, so fields may be appended.
+
+namespace binary {
+    enum Tag : uint8_t {
+        TAG_VARINT = 0,
+        TAG_BYTES = 1,
+    };
+
+    inline void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline bool takeVarint(std::span<uint8_t const>& in, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (in.empty()) return false;
+            uint8_t byte = in.front();
+            in = in.subspan(1);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    inline void putValue(std::vector<uint8_t>& out, bool value) {
+        out.push_back(TAG_VARINT);
+        out.push_back(value ? 1 : 0);
+    }
+
+    template <std::signed_integral T>
+    void putValue(std::vector<uint8_t>& out, T value) {
+        auto wide = static_cast<int64_t>(value);
+        out.push_back(TAG_VARINT);
+        putVarint(out, (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+    }
+
+    inline void putValue(std::vector<uint8_t>& out, std::string const& value) {
+        out.push_back(TAG_BYTES);
+        putVarint(out, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    inline bool takeValue(std::span<uint8_t const>& in, uint8_t tag, bool& value) {
+        uint64_t raw;
+        if (tag != TAG_VARINT || !takeVarint(in, raw)) return false;
+        value = raw != 0;
+        return true;
+    }
+
+    template <std::signed_integral T>
+    bool takeValue(std::span<uint8_t const>& in, uint8_t tag, T& value) {
+        uint64_t raw;
+        if (tag != TAG_VARINT || !takeVarint(in, raw)) return false;
+        value = static_cast<T>(static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1));
+        return true;
+    }
+
+    inline bool takeValue(std::span<uint8_t const>& in, uint8_t tag, std::string& value) {
+        uint64_t size;
+        if (tag != TAG_BYTES || !takeVarint(in, size) || size > in.size()) return false;
+        value.assign(reinterpret_cast<char const*>(in.data()), size);
+        in = in.subspan(size);
+        return true;
+    }
+
+    inline bool skipValue(std::span<uint8_t const>& in, uint8_t tag) {
+        uint64_t raw;
+        if (!takeVarint(in, raw)) return false;
+        if (tag == TAG_VARINT) return true;
+        if (tag != TAG_BYTES || raw > in.size()) return false;
+        in = in.subspan(raw);
+        return true;
+    }
+
+    template <HasSchema T>
+    void encode(std::vector<uint8_t>& out, T const& value) {
+        putVarint(out, std::tuple_size_v<std::remove_cvref_t<decltype(Schema<T>::fields)>>);
+        forEachField<T>([&](auto const& f) { putValue(out, value.*f.member); });
+    }
+
+    // Reads one record from the front of `in` and advances past it.
+    template <HasSchema T>
+    std::optional<T> decode(std::span<uint8_t const>& in) {
+        uint64_t count;
+        if (!takeVarint(in, count)) return std::nullopt;
+
+        T out{};
+        uint64_t index = 0;
+        bool ok = true;
+        forEachField<T>([&](auto const& f) {
+            if (!ok || index++ >= count) return;
+            if (in.empty()) {
+                ok = false;
+                return;
+            }
+            uint8_t tag = in.front();
+            in = in.subspan(1);
+            ok = takeValue(in, tag, out.*f.member);
+        });
+        for (; ok && index < count; ++index) {
+            if (in.empty()) return std::nullopt;
+            uint8_t tag = in.front();
+            in = in.subspan(1);
+            ok = skipValue(in, tag);
+        }
+        if (!ok) return std::nullopt;
+        return out;
+    }
+}
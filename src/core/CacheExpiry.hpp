@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ChangelogCursor.hpp"
+#include "VerifierData.hpp"
+
+#include <span>
+
+static constexpr long long CACHE_EXPIRY = 1800;
+// With disable-cache on, entries live in memory only, briefly and bounded.
+static constexpr long long SESSION_CACHE_EXPIRY = 300;
+
+// The verifier cache's expiry, as a TtlCache policy. An entry is good for
+// CACHE_EXPIRY, and past that while the changelog covers it (see
+// isCoveredByChangelog()). With disable-cache on it's good for
+// SESSION_CACHE_EXPIRY and the changelog doesn't count.
+//
+// `State` says which, without allocating:
+//
+//   bool sessionOnly() const                        disable-cache
+//   long long trackingSince() const                 the changelog's state
+//   std::span<long long const> lastPolls() const
+//
+// The mod reads its settings and feeds; the host tools set their own.
+template <class State>
+struct CacheExpiry {
+    [[no_unique_address]] State state;
+
+    bool isFresh(VerifierData const& data, long long now) const {
+        auto age = now - data.timestamp;
+        if (state.sessionOnly()) return age <= SESSION_CACHE_EXPIRY;
+        return age <= CACHE_EXPIRY ||
+            isCoveredByChangelog(data.timestamp, now, state.trackingSince(), state.lastPolls());
+    }
+};
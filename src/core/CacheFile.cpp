@@ -0,0 +1,118 @@
+#include "CacheFile.hpp"
+#include "BinaryCodec.hpp"
+#include "LevelKey.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void writeJsonCache(std::string& out, std::span<CacheEntry const> entries) {
+    out += '{';
+    bool first = true;
+    for (auto const& entry : entries) {
+        writeJsonCacheEntry(out, entry.key, entry.data, first);
+        first = false;
+    }
+    out += '}';
+}
+
+double accessHeat(VerifierData const& data, long long now) {
+    if (data.hits <= 0) return 0;
+    auto idle = static_cast<double>(std::max(now - data.seen, 0LL));
+    return data.hits * std::exp2(-idle / ACCESS_HALF_LIFE);
+}
+
+std::pair<double, long long> cacheFileRank(VerifierData const& data, long long now) {
+    return {-accessHeat(data, now), -data.timestamp};
+}
+
+void sortHottestFirst(std::vector<CacheEntry>& entries, long long now) {
+    std::vector<std::pair<std::pair<double, long long>, size_t>> order;
+    order.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) order.emplace_back(cacheFileRank(entries[i].data, now), i);
+    std::ranges::sort(order);
+    std::vector<CacheEntry> sorted;
+    sorted.reserve(entries.size());
+    for (auto const& [rank, i] : order) sorted.push_back(std::move(entries[i]));
+    entries = std::move(sorted);
+}
+
+StagedCacheReader::StagedCacheReader(std::string text) : m_text(std::move(text)), m_reader(m_text) {
+    if (!m_reader.beginObject()) m_state = State::Failed;
+}
+
+size_t StagedCacheReader::read(size_t limit, std::function<void(uint32_t key, VerifierData data)> const& onEntry) {
+    size_t count = 0;
+    while (m_state == State::Reading && count < limit) {
+        std::string_view key;
+        auto step = m_reader.nextMember(key, m_decoded);
+        if (step != JsonReader::Step::Member) {
+            m_state = step == JsonReader::Step::End && m_reader.atEnd() ? State::Done : State::Failed;
+            break;
+        }
+        if (m_reader.peek() != JsonReader::Kind::Object) {
+            if (!m_reader.skip()) m_state = State::Failed;
+            continue;
+        }
+        VerifierData data;
+        if (!readJsonRecord(m_reader, data)) {
+            m_state = State::Failed;
+            break;
+        }
+        ++count;
+        if (auto parsed = parseLevelKey(key)) onEntry(*parsed, std::move(data));
+    }
+    return count;
+}
+
+void StagedCacheReader::forEachUnread(std::function<void(uint32_t key, std::string_view record)> const& fn) const {
+    if (m_state != State::Reading) return;
+    auto reader = m_reader;
+    std::string decoded;
+    std::string_view key;
+    while (reader.nextMember(key, decoded) == JsonReader::Step::Member) {
+        bool object = reader.peek() == JsonReader::Kind::Object;
+        auto start = reader.position();
+        if (!reader.skip()) return;
+        if (!object) continue;
+        if (auto parsed = parseLevelKey(key)) fn(*parsed, std::string_view(m_text).substr(start, reader.position() - start));
+    }
+}
+
+std::vector<uint8_t> encodeBinaryCache(std::span<CacheEntry const> entries) {
+    std::vector<uint8_t> out(sizeof(CACHE_BINARY_MAGIC));
+    std::memcpy(out.data(), &CACHE_BINARY_MAGIC, sizeof(CACHE_BINARY_MAGIC));
+    binary::putVarint(out, entries.size());
+    for (auto const& entry : entries) {
+        binary::putVarint(out, entry.key);
+        binary::encode(out, entry.data);
+    }
+    return out;
+}
+
+bool isBinaryCache(std::span<uint8_t const> bytes) {
+    uint32_t magic;
+    if (bytes.size() < sizeof(magic)) return false;
+    std::memcpy(&magic, bytes.data(), sizeof(magic));
+    return magic == CACHE_BINARY_MAGIC;
+}
+
+std::optional<std::vector<CacheEntry>> decodeBinaryCache(std::span<uint8_t const> bytes) {
+    if (!isBinaryCache(bytes)) return std::nullopt;
+    auto in = bytes.subspan(sizeof(CACHE_BINARY_MAGIC));
+
+    uint64_t count;
+    if (!binary::takeVarint(in, count)) return std::nullopt;
+    std::vector<CacheEntry> entries;
+    // Every entry takes at least two bytes, which bounds a corrupt count.
+    entries.reserve(std::min<uint64_t>(count, in.size() / 2));
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t key;
+        if (!binary::takeVarint(in, key) || key > UINT32_MAX) return std::nullopt;
+        auto data = binary::decode<VerifierData>(in);
+        if (!data) return std::nullopt;
+        entries.push_back({static_cast<uint32_t>(key), std::move(*data)});
+    }
+    if (!in.empty()) return std::nullopt;
+    return entries;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "JsonReader.hpp"
+#include "LevelKey.hpp"
+#include "VerifierData.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Encoders for the verifier cache outside of the mod's own load and save
+// paths, shared with tools/cachetool.
+
+struct CacheEntry {
+    uint32_t key; // packLevelKey()
+    VerifierData data;
+};
+
+// The cache file's JSON layout, byte for byte what saveCache() writes:
+// {"<id>[_2p]":{"verifier":...,"video":...,"legacy":...,"timestamp":...,
+//  "hits":...,"seen":...},...}
+//
+// Entries go hottest first, so a reader that stops early has the ones most
+// likely to be asked for. Heat is the hit count halved for every
+// ACCESS_HALF_LIFE seconds since the last hit; ties go to the newest fetch.
+//
+// The writers below take any `out` with `+= char` and `+= std::string_view`,
+// so the same code fills a string or streams into a FileSink.
+void writeJsonCache(std::string& out, std::span<CacheEntry const> entries);
+
+static constexpr long long ACCESS_HALF_LIFE = 7 * 86400;
+
+double accessHeat(VerifierData const& data, long long now);
+// Ascending order is file order.
+std::pair<double, long long> cacheFileRank(VerifierData const& data, long long now);
+void sortHottestFirst(std::vector<CacheEntry>& entries, long long now);
+
+// Reads a JSON cache file a few entries at a time, so the hot head can be
+// used while the rest waits. Same leniency as reduceCacheFile(); keys that
+// aren't "<id>[_2p]" are skipped.
+class StagedCacheReader {
+public:
+    explicit StagedCacheReader(std::string text);
+
+    StagedCacheReader(StagedCacheReader const&) = delete;
+    StagedCacheReader& operator=(StagedCacheReader const&) = delete;
+
+    // Passes up to `limit` more entries to `onEntry`. Returns how many.
+    size_t read(size_t limit, std::function<void(uint32_t key, VerifierData data)> const& onEntry);
+    // Every entry not read yet, as the record's JSON text, without parsing
+    // the records or moving the read position. Stops quietly where read()
+    // would fail.
+    void forEachUnread(std::function<void(uint32_t key, std::string_view record)> const& fn) const;
+    // Nothing left: either the whole file was read or it stopped at a
+    // malformed spot, after keeping what came before it.
+    bool done() const {
+        return m_state != State::Reading;
+    }
+    bool failed() const {
+        return m_state == State::Failed;
+    }
+
+private:
+    enum class State { Reading, Done, Failed };
+
+    std::string m_text;
+    JsonReader m_reader; // over m_text
+    std::string m_decoded;
+    State m_state = State::Reading;
+};
+
+// Binary layout: magic "VLC1", varint count, then per entry a varint key and
+// the record in the schema codec (see BinaryCodec.hpp).
+static constexpr uint32_t CACHE_BINARY_MAGIC = 0x31434c56; // "VLC1"
+
+std::vector<uint8_t> encodeBinaryCache(std::span<CacheEntry const> entries);
+std::optional<std::vector<CacheEntry>> decodeBinaryCache(std::span<uint8_t const> bytes);
+bool isBinaryCache(std::span<uint8_t const> bytes);
+
+// JSON string contents with the escapes the cache file needs, no quotes.
+template <class Out>
+void appendJsonEscaped(Out& out, std::string_view text) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    size_t plain = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out += text.substr(plain, i - plain);
+        plain = i + 1;
+        switch (c) {
+            case '"': out += std::string_view("\\\""); break;
+            case '\\': out += std::string_view("\\\\"); break;
+            case '\b': out += std::string_view("\\b"); break;
+            case '\f': out += std::string_view("\\f"); break;
+            case '\n': out += std::string_view("\\n"); break;
+            case '\r': out += std::string_view("\\r"); break;
+            case '\t': out += std::string_view("\\t"); break;
+            default: {
+                char escape[] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xf]};
+                out += std::string_view(escape, sizeof(escape));
+            }
+        }
+    }
+    out += text.substr(plain);
+}
+
+template <class Out>
+void writeJsonValue(Out& out, std::string const& value) {
+    out += '"';
+    appendJsonEscaped(out, value);
+    out += '"';
+}
+
+template <class Out>
+void writeJsonValue(Out& out, bool value) {
+    out += std::string_view(value ? "true" : "false");
+}
+
+template <class Out, std::signed_integral T>
+void writeJsonValue(Out& out, T value) {
+    char buf[24];
+    auto end = std::to_chars(buf, buf + sizeof(buf), value).ptr;
+    out += std::string_view(buf, end - buf);
+}
+
+// `"<key>":`, preceded by a comma unless it is the first member.
+template <class Out>
+void writeJsonCacheKey(Out& out, uint32_t key, bool first) {
+    if (!first) out += ',';
+    char buf[24];
+    auto end = std::to_chars(buf, buf + sizeof(buf), levelIDFromKey(key)).ptr;
+    out += '"';
+    out += std::string_view(buf, end - buf);
+    if (isDuoKey(key)) out += std::string_view("_2p");
+    out += std::string_view("\":");
+}
+
+// One `"<key>":<record>` member with the record copied as is.
+template <class Out>
+void writeJsonCacheRecord(Out& out, uint32_t key, std::string_view record, bool first) {
+    writeJsonCacheKey(out, key, first);
+    out += record;
+}
+
+// `,"<name>":` for field I of T, built at compile time so writing a member
+// name is a single append.
+template <HasSchema T, size_t I>
+inline constexpr auto JSON_FIELD_PREFIX = [] {
+    constexpr std::string_view name = std::get<I>(Schema<T>::fields).name;
+    std::array<char, name.size() + 4> out{};
+    out[0] = ',';
+    out[1] = '"';
+    std::ranges::copy(name, out.begin() + 2);
+    out[name.size() + 2] = '"';
+    out[name.size() + 3] = ':';
+    return out;
+}();
+
+template <size_t I, class Out>
+void writeJsonCacheField(Out& out, VerifierData const& data) {
+    constexpr auto const& prefix = JSON_FIELD_PREFIX<VerifierData, I>;
+    // The first field goes without the comma.
+    out += std::string_view(prefix.data() + (I == 0), prefix.size() - (I == 0));
+    writeJsonValue(out, data.*std::get<I>(Schema<VerifierData>::fields).member);
+}
+
+// One `"<key>":{...}` member, preceded by a comma unless it is the first.
+template <class Out>
+void writeJsonCacheEntry(Out& out, uint32_t key, VerifierData const& data, bool first) {
+    writeJsonCacheKey(out, key, first);
+    out += '{';
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (writeJsonCacheField<I>(out, data), ...);
+    }(std::make_index_sequence<std::tuple_size_v<decltype(Schema<VerifierData>::fields)>>());
+    out += '}';
+}
@@ -0,0 +1,31 @@
+#include "ChangelogCursor.hpp"
+
+#include <algorithm>
+
+ChangelogPoll applyChangelog(std::string_view cursor, std::vector<ChangelogEntry> const& entries) {
+    ChangelogPoll poll;
+    poll.cursor = cursor;
+    bool overlaps = false;
+
+    for (auto const& entry : entries) {
+        if (entry.createdAt.empty()) continue;
+        poll.cursor = std::max(poll.cursor, entry.createdAt);
+        if (!cursor.empty() && entry.createdAt <= cursor) {
+            overlaps = true;
+            continue;
+        }
+        poll.changed.insert(poll.changed.end(), entry.levelIDs.begin(), entry.levelIDs.end());
+    }
+
+    // Without an entry at or before the cursor, changes may have been missed.
+    poll.gap = cursor.empty() || (!overlaps && !entries.empty());
+    return poll;
+}
+
+bool isCoveredByChangelog(long long timestamp, long long now, long long trackingSince, std::span<long long const> lastPolls) {
+    if (now - timestamp > CHANGELOG_MAX_AGE) return false;
+    if (trackingSince == 0 || timestamp < trackingSince) return false;
+    return std::ranges::all_of(lastPolls, [&](long long lastPoll) {
+        return lastPoll <= now && now - lastPoll <= CHANGELOG_TRUST_WINDOW;
+    });
+}
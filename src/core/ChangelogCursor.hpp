@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ResponseReducer.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// How a list's changelog feed keeps cache entries valid. Each poll applies
+// the changes newer than the cursor (the newest created_at seen so far);
+// while every feed has been polled recently and without gaps, entries that
+// no change touched stay valid for up to CHANGELOG_MAX_AGE.
+static constexpr long long CHANGELOG_POLL_INTERVAL = 600;
+static constexpr long long CHANGELOG_MAX_AGE = 7 * 24 * 3600;
+// How long a feed's last successful poll vouches for it, including across
+// restarts. No longer than a plain entry is trusted (CACHE_EXPIRY), so a
+// change is never missed for longer than without the changelog.
+static constexpr long long CHANGELOG_TRUST_WINDOW = 1800;
+
+struct ChangelogPoll {
+    std::string cursor;       // for the next poll
+    std::vector<int> changed; // levels touched after the old cursor
+    // Nothing at or before the old cursor came back, so changes may have
+    // been missed; entries fetched before now can't be vouched for.
+    bool gap = false;
+};
+
+ChangelogPoll applyChangelog(std::string_view cursor, std::vector<ChangelogEntry> const& entries);
+
+// True if an entry fetched at `timestamp` is covered: tracking (without a
+// gap) started at or before it, it is younger than CHANGELOG_MAX_AGE, and
+// every feed's last successful poll is within CHANGELOG_TRUST_WINDOW.
+bool isCoveredByChangelog(long long timestamp, long long now, long long trackingSince, std::span<long long const> lastPolls);
@@ -0,0 +1,40 @@
+#include "ConcurrencyLimit.hpp"
+
+#include <algorithm>
+
+// How quickly the baseline creeps back up towards recent round trips, so a
+// route change to a slower path doesn't read as permanent congestion.
+static constexpr double BASELINE_DRIFT = 0.02;
+// Below this, round-trip jitter is noise rather than queueing.
+static constexpr double MIN_BASELINE = 0.05;
+
+void ConcurrencyLimit::decrease(double factor, double now) {
+    m_limit = std::max(MIN_LIMIT, m_limit * factor);
+    m_lastDecrease = now;
+}
+
+bool ConcurrencyLimit::onSample(double sentAt, double receivedAt, Signal signal) {
+    auto before = limit();
+    bool canDecrease = sentAt > m_lastDecrease;
+
+    if (signal == Signal::Congested) {
+        if (canDecrease) decrease(0.5, receivedAt);
+        return limit() != before;
+    }
+
+    double rtt = std::max(receivedAt - sentAt, 0.0);
+    if (m_baselineRtt <= 0 || rtt < m_baselineRtt) {
+        m_baselineRtt = rtt;
+    }
+    else {
+        m_baselineRtt += (rtt - m_baselineRtt) * BASELINE_DRIFT;
+    }
+
+    if (rtt > std::max(m_baselineRtt, MIN_BASELINE) * LATENCY_TOLERANCE) {
+        if (canDecrease) decrease(0.75, receivedAt);
+    }
+    else {
+        m_limit = std::min(MAX_LIMIT, m_limit + 1.0 / m_limit);
+    }
+    return limit() != before;
+}
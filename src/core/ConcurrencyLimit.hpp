@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+// AIMD limit on requests in flight. Each response is a sample: while its
+// round trip stays near the best recently seen, the limit grows by about one
+// per window of responses; a rate limit or server error halves it, and a
+// round trip well above the baseline (requests queueing somewhere) cuts it
+// by a quarter. Only responses sent after the last cut can cut again, so one
+// burst of bad responses counts once.
+class ConcurrencyLimit {
+public:
+    enum class Signal {
+        Ok,         // any answer from the API, including 404
+        Congested,  // 429, 5xx or no answer at all
+    };
+
+    static constexpr double MIN_LIMIT = 1.0;
+    static constexpr double MAX_LIMIT = 16.0;
+    static constexpr double INITIAL_LIMIT = 4.0;
+    // A round trip this many times the baseline counts as queueing.
+    static constexpr double LATENCY_TOLERANCE = 2.0;
+
+    // Times are in seconds on any monotonic clock.
+    // Returns true if limit() changed as a result.
+    bool onSample(double sentAt, double receivedAt, Signal signal);
+
+    size_t limit() const {
+        return static_cast<size_t>(m_limit);
+    }
+    double baselineRtt() const {
+        return m_baselineRtt;
+    }
+
+private:
+    void decrease(double factor, double now);
+
+    double m_limit = INITIAL_LIMIT;
+    double m_baselineRtt = 0;
+    double m_lastDecrease = -1;
+};
@@ -0,0 +1,95 @@
+#include "DiskLru.hpp"
+
+#include <algorithm>
+#include <vector>
+
+DiskLru::DiskLru(std::filesystem::path dir, uint64_t maxBytes) : m_dir(std::move(dir)), m_maxBytes(maxBytes) {}
+
+void DiskLru::scan() {
+    std::error_code ec;
+    std::filesystem::create_directories(m_dir, ec);
+
+    struct Found {
+        std::string name;
+        uint64_t bytes;
+        std::filesystem::file_time_type usedAt;
+    };
+    std::vector<Found> found;
+    for (auto const& entry : std::filesystem::directory_iterator(m_dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        auto name = entry.path().filename().string();
+        // Leftovers of an interrupted write.
+        if (name.ends_with(".tmp")) {
+            std::filesystem::remove(entry.path(), ec);
+            continue;
+        }
+        auto bytes = entry.file_size(ec);
+        if (ec) continue;
+        auto usedAt = entry.last_write_time(ec);
+        if (ec) continue;
+        found.push_back({std::move(name), bytes, usedAt});
+    }
+
+    // Oldest first, so the most recent ends up at the front of the order.
+    std::ranges::sort(found, {}, &Found::usedAt);
+    m_sizes.clear();
+    m_order = ttl::LruEviction<std::string>();
+    m_bytes = 0;
+    for (auto& f : found) {
+        m_order.onInsert(f.name);
+        m_bytes += f.bytes;
+        m_sizes.emplace(std::move(f.name), f.bytes);
+    }
+    trim();
+}
+
+std::filesystem::path DiskLru::pathFor(std::string const& name) const {
+    return m_dir / name;
+}
+
+bool DiskLru::touch(std::string const& name) {
+    if (!m_sizes.contains(name)) return false;
+    m_order.onAccess(name);
+    std::error_code ec;
+    std::filesystem::last_write_time(pathFor(name), std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+size_t DiskLru::add(std::string const& name, uint64_t bytes) {
+    auto [it, inserted] = m_sizes.try_emplace(name, bytes);
+    if (inserted) {
+        m_order.onInsert(name);
+    }
+    else {
+        m_bytes -= it->second;
+        it->second = bytes;
+        m_order.onAccess(name);
+    }
+    m_bytes += bytes;
+    return trim();
+}
+
+void DiskLru::remove(std::string const& name) {
+    auto it = m_sizes.find(name);
+    if (it == m_sizes.end()) return;
+    std::error_code ec;
+    std::filesystem::remove(pathFor(name), ec);
+    m_bytes -= it->second;
+    m_order.onErase(name);
+    m_sizes.erase(it);
+}
+
+void DiskLru::clear() {
+    while (auto victim = m_order.victim(m_sizes)) remove(*victim);
+}
+
+size_t DiskLru::trim() {
+    size_t evicted = 0;
+    while (m_bytes > m_maxBytes && m_sizes.size() > 1) {
+        auto victim = m_order.victim(m_sizes);
+        if (!victim) break;
+        remove(*victim);
+        ++evicted;
+    }
+    return evicted;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "TtlCache.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+// A directory of files kept under a total size by deleting the least
+// recently used. Recency survives restarts through modification times.
+//
+// The index isn't thread-safe and belongs to one thread; file contents may be
+// read and written from others through pathFor().
+class DiskLru {
+public:
+    DiskLru(std::filesystem::path dir, uint64_t maxBytes);
+
+    // Indexes the directory, creating it if needed, and trims it to size.
+    void scan();
+
+    std::filesystem::path pathFor(std::string const& name) const;
+    // Marks `name` used. False if it isn't stored.
+    bool touch(std::string const& name);
+    // Records a file just written to pathFor(name). Returns how many files
+    // were deleted to make room; the new file itself is always kept.
+    size_t add(std::string const& name, uint64_t bytes);
+    void remove(std::string const& name);
+    // Deletes every indexed file.
+    void clear();
+
+    uint64_t bytes() const {
+        return m_bytes;
+    }
+    size_t size() const {
+        return m_sizes.size();
+    }
+
+private:
+    size_t trim();
+
+    std::filesystem::path m_dir;
+    uint64_t m_maxBytes;
+    uint64_t m_bytes = 0;
+    std::unordered_map<std::string, uint64_t> m_sizes;
+    ttl::LruEviction<std::string> m_order;
+};
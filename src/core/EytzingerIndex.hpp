@@ -0,0 +1,90 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+// Immutable index over unique uint32 keys stored in Eytzinger (BFS) order,
+// with a parallel array of values. Slot 0 is padding so that the children of
+// slot k are 2k and 2k + 1. The index only views its arrays, which lets them
+// live directly inside a mapped file.
+class EytzingerIndex {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    EytzingerIndex() = default;
+    EytzingerIndex(uint32_t const* keys, uint32_t const* values, size_t count)
+        : m_keys(keys), m_values(values), m_count(count) {}
+
+    // Number of array slots needed to hold `count` keys.
+    static constexpr size_t slots(size_t count) {
+        return count + 1;
+    }
+
+    // Lays out `sorted` (ascending, unique keys) into `keys` and `values`,
+    // which must both hold slots(sorted.size()) elements.
+    static void build(
+        std::span<std::pair<uint32_t, uint32_t> const> sorted,
+        uint32_t* keys, uint32_t* values
+    ) {
+        keys[0] = 0;
+        values[0] = npos;
+        size_t next = 0;
+        fill(sorted, keys, values, 1, next);
+    }
+
+    // Returns the value stored for `key`, or npos. The descent is branchless
+    // and prefetches the cache line holding the node four levels below.
+    uint32_t find(uint32_t key) const {
+        size_t k = 1;
+        while (k <= m_count) {
+            prefetch(m_keys + k * PREFETCH_STRIDE);
+            k = 2 * k + (m_keys[k] < key);
+        }
+        k >>= std::countr_one(k) + 1;
+        if (k == 0 || m_keys[k] != key) return npos;
+        return m_values[k];
+    }
+
+    bool contains(uint32_t key) const {
+        return find(key) != npos;
+    }
+
+    size_t size() const {
+        return m_count;
+    }
+
+    bool empty() const {
+        return m_count == 0;
+    }
+
+private:
+    // 16 keys per 64-byte line: the great-great-grandchildren of k start at 16k.
+    static constexpr size_t PREFETCH_STRIDE = 16;
+
+    static void prefetch(void const* p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void)p;
+#endif
+    }
+
+    static void fill(
+        std::span<std::pair<uint32_t, uint32_t> const> sorted,
+        uint32_t* keys, uint32_t* values, size_t k, size_t& next
+    ) {
+        if (k > sorted.size()) return;
+        fill(sorted, keys, values, 2 * k, next);
+        keys[k] = sorted[next].first;
+        values[k] = sorted[next].second;
+        ++next;
+        fill(sorted, keys, values, 2 * k + 1, next);
+    }
+
+    uint32_t const* m_keys = nullptr;
+    uint32_t const* m_values = nullptr;
+    size_t m_count = 0;
+};
@@ -0,0 +1,51 @@
+#include "FileSink.hpp"
+#include "AsyncIo.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+FileSink::FileSink(std::filesystem::path path)
+    : m_path(std::move(path)), m_buffer(std::make_unique<char[]>(BUFFER_SIZE)) {
+    m_temp = m_path;
+    m_temp += ".tmp";
+    m_file.open(m_temp, std::ios::binary | std::ios::trunc);
+}
+
+FileSink::~FileSink() {
+    if (m_committed) return;
+    m_file.close();
+    std::error_code ec;
+    std::filesystem::remove(m_temp, ec);
+}
+
+FileSink& FileSink::operator+=(std::string_view text) {
+    while (!text.empty()) {
+        if (m_used == BUFFER_SIZE) flush();
+        size_t n = std::min(text.size(), BUFFER_SIZE - m_used);
+        std::memcpy(m_buffer.get() + m_used, text.data(), n);
+        m_used += n;
+        text.remove_prefix(n);
+    }
+    return *this;
+}
+
+void FileSink::flush() {
+    m_file.write(m_buffer.get(), static_cast<std::streamsize>(m_used));
+    m_written += m_used;
+    m_used = 0;
+}
+
+bool FileSink::commit() {
+    flush();
+    m_file.close();
+    if (m_file.fail()) return false;
+    // Otherwise the rename can reach the disk before the data does, and a
+    // crash leaves an empty file in place of the old one.
+    if (!blockingSync(m_temp).ok) return false;
+
+    std::error_code ec;
+    std::filesystem::rename(m_temp, m_path, ec);
+    if (ec) return false;
+    m_committed = true;
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string_view>
+
+// Buffered, write-only file output that never holds more than BUFFER_SIZE
+// bytes. Everything goes to "<path>.tmp", which is fsynced and then replaces
+// `path` on commit(), so a failed or abandoned write, or a crash right after
+// the rename, leaves a complete file behind; the same guarantee as
+// AsyncIo::replace().
+class FileSink {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    explicit FileSink(std::filesystem::path path);
+    // Removes the temporary file unless commit() succeeded.
+    ~FileSink();
+
+    FileSink(FileSink const&) = delete;
+    FileSink& operator=(FileSink const&) = delete;
+
+    FileSink& operator+=(char c) {
+        if (m_used == BUFFER_SIZE) flush();
+        m_buffer[m_used++] = c;
+        return *this;
+    }
+    FileSink& operator+=(std::string_view text);
+
+    // Flushes, closes, fsyncs and renames into place. False if any write
+    // failed.
+    bool commit();
+    // Bytes written so far, buffered or not.
+    size_t size() const {
+        return m_written + m_used;
+    }
+
+private:
+    void flush();
+
+    std::filesystem::path m_path;
+    std::filesystem::path m_temp;
+    std::ofstream m_file;
+    std::unique_ptr<char[]> m_buffer;
+    size_t m_used = 0;
+    size_t m_written = 0;
+    bool m_committed = false;
+};
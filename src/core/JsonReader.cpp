@@ -0,0 +1,259 @@
+#include "JsonReader.hpp"
+
+#include <charconv>
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+    else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+    else {
+        out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+}
+
+static bool readHex4(std::string_view raw, size_t& i, uint32_t& out) {
+    if (i + 4 > raw.size()) return false;
+    out = 0;
+    for (size_t end = i + 4; i < end; ++i) {
+        int v = hexValue(raw[i]);
+        if (v < 0) return false;
+        out = (out << 4) | static_cast<uint32_t>(v);
+    }
+    return true;
+}
+
+bool decodeJsonString(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size();) {
+        char c = raw[i++];
+        if (c != '\\') {
+            out.push_back(c);
+            continue;
+        }
+        if (i >= raw.size()) return false;
+        switch (raw[i++]) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp;
+                if (!readHex4(raw, i, cp)) return false;
+                if (cp >= 0xd800 && cp <= 0xdbff) {
+                    uint32_t low;
+                    if (i + 2 > raw.size() || raw[i] != '\\' || raw[i + 1] != 'u') return false;
+                    i += 2;
+                    if (!readHex4(raw, i, low) || low < 0xdc00 || low > 0xdfff) return false;
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                }
+                else if (cp >= 0xdc00 && cp <= 0xdfff) {
+                    return false;
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: return false;
+        }
+    }
+    return true;
+}
+
+void JsonReader::skipWhitespace() {
+    while (m_pos < m_json.size()) {
+        char c = m_json[m_pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+        ++m_pos;
+    }
+}
+
+bool JsonReader::consume(char c) {
+    skipWhitespace();
+    if (m_pos < m_json.size() && m_json[m_pos] == c) {
+        ++m_pos;
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::atEnd() {
+    skipWhitespace();
+    return m_pos == m_json.size();
+}
+
+JsonReader::Kind JsonReader::peek() {
+    skipWhitespace();
+    if (m_pos >= m_json.size()) return Kind::Invalid;
+    switch (m_json[m_pos]) {
+        case '{': return Kind::Object;
+        case '[': return Kind::Array;
+        case '"': return Kind::String;
+        case 't': case 'f': return Kind::Bool;
+        case 'n': return Kind::Null;
+        default: return m_json[m_pos] == '-' || isDigit(m_json[m_pos]) ? Kind::Number : Kind::Invalid;
+    }
+}
+
+// Scans a string starting at the opening quote; `raw` excludes the quotes.
+bool JsonReader::scanString(std::string_view& raw, bool& escaped) {
+    if (peek() != Kind::String) return false;
+    size_t start = ++m_pos;
+    escaped = false;
+    while (m_pos < m_json.size()) {
+        char c = m_json[m_pos];
+        if (c == '"') {
+            raw = m_json.substr(start, m_pos - start);
+            ++m_pos;
+            return true;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) return false;
+        if (c == '\\') {
+            escaped = true;
+            ++m_pos;
+        }
+        ++m_pos;
+    }
+    return false;
+}
+
+bool JsonReader::readKey(std::string_view& key, std::string& decoded) {
+    bool escaped;
+    if (!scanString(key, escaped)) return false;
+    if (escaped) {
+        if (!decodeJsonString(key, decoded)) return false;
+        key = decoded;
+    }
+    return true;
+}
+
+bool JsonReader::beginObject() {
+    m_members = 0;
+    return consume('{');
+}
+
+JsonReader::Step JsonReader::nextMember(std::string_view& key, std::string& decoded) {
+    if (consume('}')) return Step::End;
+    if (m_members > 0 && !consume(',')) return Step::Error;
+    if (!readKey(key, decoded) || !consume(':')) return Step::Error;
+    ++m_members;
+    return Step::Member;
+}
+
+bool JsonReader::readString(std::string& out) {
+    std::string_view raw;
+    bool escaped;
+    if (!scanString(raw, escaped)) return false;
+    if (escaped) return decodeJsonString(raw, out);
+    out.assign(raw);
+    return true;
+}
+
+bool JsonReader::readBool(bool& out) {
+    if (peek() != Kind::Bool) return false;
+    auto rest = m_json.substr(m_pos);
+    if (rest.starts_with("true")) {
+        out = true;
+        m_pos += 4;
+        return true;
+    }
+    if (rest.starts_with("false")) {
+        out = false;
+        m_pos += 5;
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::readNull() {
+    if (peek() != Kind::Null || !m_json.substr(m_pos).starts_with("null")) return false;
+    m_pos += 4;
+    return true;
+}
+
+bool JsonReader::readInt(int64_t& out) {
+    if (peek() != Kind::Number) return false;
+    auto begin = m_json.data() + m_pos;
+    auto end = m_json.data() + m_json.size();
+    auto [ptr, ec] = std::from_chars(begin, end, out);
+    if (ec != std::errc()) return false;
+    m_pos = ptr - m_json.data();
+
+    // Drop any fraction or exponent.
+    if (m_pos < m_json.size() && m_json[m_pos] == '.') {
+        ++m_pos;
+        if (m_pos >= m_json.size() || !isDigit(m_json[m_pos])) return false;
+        while (m_pos < m_json.size() && isDigit(m_json[m_pos])) ++m_pos;
+    }
+    if (m_pos < m_json.size() && (m_json[m_pos] == 'e' || m_json[m_pos] == 'E')) {
+        ++m_pos;
+        if (m_pos < m_json.size() && (m_json[m_pos] == '+' || m_json[m_pos] == '-')) ++m_pos;
+        if (m_pos >= m_json.size() || !isDigit(m_json[m_pos])) return false;
+        while (m_pos < m_json.size() && isDigit(m_json[m_pos])) ++m_pos;
+    }
+    return true;
+}
+
+bool JsonReader::skip() {
+    return skipValue(0);
+}
+
+bool JsonReader::skipValue(int depth) {
+    if (depth > MAX_DEPTH) return false;
+    switch (peek()) {
+        case Kind::Object:
+            return readObject([&](std::string_view) { return skipValue(depth + 1); });
+        case Kind::Array:
+            return readArray([&] { return skipValue(depth + 1); });
+        case Kind::String: {
+            std::string_view raw;
+            bool escaped;
+            return scanString(raw, escaped);
+        }
+        case Kind::Number: {
+            int64_t ignored;
+            if (readInt(ignored)) return true;
+            // Out of int64 range: scan the number lexically instead.
+            while (m_pos < m_json.size()) {
+                char c = m_json[m_pos];
+                if (!isDigit(c) && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') break;
+                ++m_pos;
+            }
+            return true;
+        }
+        case Kind::Bool: {
+            bool ignored;
+            return readBool(ignored);
+        }
+        case Kind::Null:
+            return readNull();
+        default:
+            return false;
+    }
+}
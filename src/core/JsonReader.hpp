@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Schema.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Single-pass JSON reader over a borrowed buffer. Nothing is materialized
+// unless asked for: callers walk objects and arrays with callbacks and either
+// read each value or skip() it.
+//
+//   reader.readObject([&](std::string_view key) {
+//       if (key == "legacy") return reader.readBool(legacy);
+//       return reader.skip();
+//   });
+//
+// Every read returns false on malformed input or a type mismatch, and the
+// failure propagates out of the enclosing readObject()/readArray().
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view json) : m_json(json) {}
+
+    enum class Kind { Object, Array, String, Number, Bool, Null, Invalid };
+
+    // Kind of the next value, without consuming it.
+    Kind peek();
+
+    bool readString(std::string& out);
+    bool readBool(bool& out);
+    // Integers only; a fractional part or exponent is truncated away.
+    bool readInt(int64_t& out);
+    bool readNull();
+    bool skip();
+
+    // Calls `onMember(key)` for every member; it must consume the value.
+    template <class F>
+    bool readObject(F&& onMember) {
+        if (!consume('{')) return false;
+        if (consume('}')) return true;
+        std::string decoded;
+        do {
+            std::string_view key;
+            if (!readKey(key, decoded) || !consume(':')) return false;
+            if (!onMember(key)) return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // readObject() a member at a time, for callers that stop between members
+    // and come back later: beginObject() once, then nextMember() until it
+    // says End, consuming each member's value in between. One object at a
+    // time; nested objects go through readObject() as usual.
+    enum class Step { Member, End, Error };
+    bool beginObject();
+    Step nextMember(std::string_view& key, std::string& decoded);
+
+    // Calls `onElement()` for every element; it must consume the value.
+    template <class F>
+    bool readArray(F&& onElement) {
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        do {
+            if (!onElement()) return false;
+        } while (consume(','));
+        return consume(']');
+    }
+
+    // True once only whitespace is left.
+    bool atEnd();
+    // Offset of the next unread byte. Right after peek(), where the next
+    // value starts; right after a read or skip(), where it ended.
+    size_t position() const {
+        return m_pos;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 256;
+
+    void skipWhitespace();
+    bool consume(char c);
+    bool readKey(std::string_view& key, std::string& decoded);
+    bool scanString(std::string_view& raw, bool& escaped);
+    bool skipValue(int depth);
+
+    std::string_view m_json;
+    size_t m_pos = 0;
+    size_t m_members = 0; // read so far by nextMember()
+};
+
+bool decodeJsonString(std::string_view raw, std::string& out);
+
+template <std::signed_integral T>
+bool readJsonField(JsonReader& reader, T& out) {
+    int64_t value;
+    if (!reader.readInt(value)) return false;
+    out = static_cast<T>(value);
+    return true;
+}
+
+inline bool readJsonField(JsonReader& reader, bool& out) {
+    return reader.readBool(out);
+}
+
+inline bool readJsonField(JsonReader& reader, std::string& out) {
+    return reader.readString(out);
+}
+
+// Reads an object into a Schema'd struct. Unknown members are skipped and
+// members of the wrong type leave the field at its default, matching the
+// lenient matjson codec.
+template <HasSchema T>
+bool readJsonRecord(JsonReader& reader, T& out) {
+    return reader.readObject([&](std::string_view key) {
+        bool ok = true;
+        bool known = visitField<T>(key, [&](auto const& f) {
+            if (!readJsonField(reader, out.*f.member)) ok = reader.skip();
+        });
+        return known ? ok : reader.skip();
+    });
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Packs a level ID and its 2P flag into one word. GD level IDs are positive
+// 31-bit integers, so the shifted ID always fits.
+constexpr uint32_t packLevelKey(int levelID, bool duo) {
+    return (static_cast<uint32_t>(levelID) << 1) | (duo ? 1u : 0u);
+}
+
+constexpr int levelIDFromKey(uint32_t key) {
+    return static_cast<int>(key >> 1);
+}
+
+constexpr bool isDuoKey(uint32_t key) {
+    return (key & 1u) != 0;
+}
+
+// "<id>" or "<id>_2p", as used by the API and the JSON cache file.
+inline std::string formatLevelKey(uint32_t key) {
+    return std::to_string(levelIDFromKey(key)) + (isDuoKey(key) ? "_2p" : "");
+}
+
+inline std::optional<uint32_t> parseLevelKey(std::string_view str) {
+    bool duo = str.ends_with("_2p");
+    if (duo) str.remove_suffix(3);
+    int id = 0;
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), id);
+    if (ec != std::errc() || end != str.data() + str.size() || id <= 0) return std::nullopt;
+    return packLevelKey(id, duo);
+}
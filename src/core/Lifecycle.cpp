@@ -0,0 +1,49 @@
+#include "Lifecycle.hpp"
+
+#include <utility>
+
+struct RegisteredHandler {
+    LifecyclePhase phase;
+    char const* name;
+    LifecycleHandler handler;
+};
+
+// Function-local so handlers can register from static initializers.
+static std::vector<RegisteredHandler>& handlers() {
+    static std::vector<RegisteredHandler> s_handlers;
+    return s_handlers;
+}
+
+void addLifecycleHandler(LifecyclePhase phase, char const* name, LifecycleHandler handler) {
+    handlers().push_back({phase, name, std::move(handler)});
+}
+
+LifecycleReport dispatchLifecycle(LifecycleEvent event, std::chrono::milliseconds budget) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto deadline = start + budget;
+
+    LifecycleReport report;
+    for (auto phase : {LifecyclePhase::Persist, LifecyclePhase::Flush, LifecyclePhase::Trim}) {
+        for (auto const& registered : handlers()) {
+            if (registered.phase != phase) continue;
+            auto stepStart = Clock::now();
+            registered.handler(event, deadline);
+            std::chrono::duration<double> took = Clock::now() - stepStart;
+            report.steps.push_back({registered.name, took.count()});
+        }
+    }
+    auto end = Clock::now();
+    report.seconds = std::chrono::duration<double>(end - start).count();
+    report.overran = end > deadline;
+    return report;
+}
+
+char const* lifecycleEventName(LifecycleEvent event) {
+    switch (event) {
+        case LifecycleEvent::Background: return "background";
+        case LifecycleEvent::Foreground: return "foreground";
+        case LifecycleEvent::LowMemory: return "low memory";
+    }
+    return "?";
+}
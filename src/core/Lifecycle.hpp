@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// App lifecycle events and the handlers subsystems register for them. The
+// mod dispatches these from the game's background/foreground and memory
+// warning hooks; host tools dispatch them directly to simulate a phone.
+enum class LifecycleEvent { Background, Foreground, LowMemory };
+
+// Handlers run phase by phase: everything that queues a write does so before
+// anything waits for writes to land, and memory is released last.
+enum class LifecyclePhase { Persist, Flush, Trim };
+
+using LifecycleDeadline = std::chrono::steady_clock::time_point;
+using LifecycleHandler = std::function<void(LifecycleEvent event, LifecycleDeadline deadline)>;
+
+// Handlers within a phase run in registration order. `name` must outlive the
+// registry; string literals do.
+void addLifecycleHandler(LifecyclePhase phase, char const* name, LifecycleHandler handler);
+
+struct LifecycleReport {
+    struct Step {
+        char const* name;
+        double seconds;
+    };
+    std::vector<Step> steps;
+    double seconds = 0;
+    bool overran = false; // finished past the deadline
+};
+
+// Runs every handler for `event` with a deadline `budget` from now. Handlers
+// are expected to bound their own waits by it; all of them run regardless.
+LifecycleReport dispatchLifecycle(LifecycleEvent event, std::chrono::milliseconds budget);
+
+char const* lifecycleEventName(LifecycleEvent event);
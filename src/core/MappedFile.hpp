@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+// Read-only memory mapping of a whole file. The mapping is released when the
+// object is destroyed; the file handle itself is closed right after mapping.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    static std::optional<MappedFile> open(std::filesystem::path const& path);
+
+    std::span<uint8_t const> bytes() const {
+        return {static_cast<uint8_t const*>(m_data), m_size};
+    }
+
+    explicit operator bool() const {
+        return m_data != nullptr;
+    }
+
+private:
+    void release();
+
+    void const* m_data = nullptr;
+    size_t m_size = 0;
+};
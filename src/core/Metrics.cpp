@@ -0,0 +1,108 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+static Metric*& registryHead() {
+    static Metric* head = nullptr;
+    return head;
+}
+
+static Metric*& registryTail() {
+    static Metric* tail = nullptr;
+    return tail;
+}
+
+static void appendNumber(std::string& out, double value) {
+    if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, ec == std::errc() ? end : buf);
+}
+
+Metric::Metric(char const* name, char const* help, char const* labels)
+    : m_name(name), m_help(help), m_labels(labels) {
+    // Registration happens during static initialization, before any thread
+    // that could read the list exists.
+    if (registryTail()) registryTail()->m_next = this;
+    else registryHead() = this;
+    registryTail() = this;
+}
+
+void Metric::writeSample(std::string& out, char const* suffix, char const* extra, double value) const {
+    out += m_name;
+    out += suffix;
+    bool hasLabels = *m_labels || *extra;
+    if (hasLabels) {
+        out += '{';
+        out += m_labels;
+        if (*m_labels && *extra) out += ',';
+        out += extra;
+        out += '}';
+    }
+    out += ' ';
+    appendNumber(out, value);
+    out += '\n';
+}
+
+void Counter::write(std::string& out) const {
+    writeSample(out, "_total", "", static_cast<double>(m_value.load(std::memory_order_relaxed)));
+}
+
+void Gauge::write(std::string& out) const {
+    writeSample(out, "", "", static_cast<double>(m_value.load(std::memory_order_relaxed)));
+}
+
+Histogram::Histogram(char const* name, char const* help, std::initializer_list<double> bounds, char const* labels)
+    : Metric(name, help, labels), m_bounds(bounds), m_buckets(new std::atomic<uint64_t>[bounds.size() + 1]) {
+    for (size_t i = 0; i <= m_bounds.size(); ++i) m_buckets[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(double seconds) {
+    size_t i = 0;
+    while (i < m_bounds.size() && seconds > m_bounds[i]) ++i;
+    m_buckets[i].fetch_add(1, std::memory_order_relaxed);
+    auto micros = std::llround(std::max(seconds, 0.0) * 1e6);
+    m_sumMicros.fetch_add(static_cast<uint64_t>(micros), std::memory_order_relaxed);
+}
+
+void Histogram::write(std::string& out) const {
+    uint64_t cumulative = 0;
+    std::string le;
+    for (size_t i = 0; i <= m_bounds.size(); ++i) {
+        cumulative += m_buckets[i].load(std::memory_order_relaxed);
+        le = "le=\"";
+        appendNumber(le, i < m_bounds.size() ? m_bounds[i] : INFINITY);
+        le += '"';
+        writeSample(out, "_bucket", le.c_str(), static_cast<double>(cumulative));
+    }
+    writeSample(out, "_count", "", static_cast<double>(cumulative));
+    writeSample(out, "_sum", "", static_cast<double>(m_sumMicros.load(std::memory_order_relaxed)) / 1e6);
+}
+
+std::string formatOpenMetrics() {
+    std::string out;
+    char const* family = nullptr;
+    for (auto metric = registryHead(); metric; metric = metric->m_next) {
+        if (!family || std::strcmp(family, metric->m_name) != 0) {
+            family = metric->m_name;
+            out += "# TYPE ";
+            out += family;
+            out += ' ';
+            out += metric->type();
+            out += "\n# HELP ";
+            out += family;
+            out += ' ';
+            out += metric->m_help;
+            out += '\n';
+        }
+        metric->write(out);
+    }
+    out += "# EOF\n";
+    return out;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Process-wide counters, gauges and histograms, written out in the
+// OpenMetrics text format. Updates are relaxed atomics: nothing is ordered
+// against anything else, it only has to add up.
+//
+// Metrics register themselves on construction and are meant to be globals,
+// one object per label set. Objects sharing a name form one family and must
+// be defined next to each other:
+//
+//   Counter hits{"cache_lookups", "Cache lookups.", R"(result="hit")"};
+//   Counter misses{"cache_lookups", "Cache lookups.", R"(result="miss")"};
+class Metric {
+public:
+    virtual ~Metric() = default;
+    Metric(Metric const&) = delete;
+    Metric& operator=(Metric const&) = delete;
+
+protected:
+    Metric(char const* name, char const* help, char const* labels);
+
+    friend std::string formatOpenMetrics();
+    virtual char const* type() const = 0;
+    virtual void write(std::string& out) const = 0;
+
+    // `suffix` goes after the family name, `extra` after the label set.
+    void writeSample(std::string& out, char const* suffix, char const* extra, double value) const;
+
+    char const* m_name;
+    char const* m_help;
+    char const* m_labels;
+    Metric* m_next = nullptr;
+};
+
+class Counter final : public Metric {
+public:
+    Counter(char const* name, char const* help, char const* labels = "") : Metric(name, help, labels) {}
+
+    void add(uint64_t n = 1) {
+        m_value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+private:
+    char const* type() const override {
+        return "counter";
+    }
+    void write(std::string& out) const override;
+
+    std::atomic<uint64_t> m_value{0};
+};
+
+class Gauge final : public Metric {
+public:
+    Gauge(char const* name, char const* help, char const* labels = "") : Metric(name, help, labels) {}
+
+    void set(int64_t value) {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+private:
+    char const* type() const override {
+        return "gauge";
+    }
+    void write(std::string& out) const override;
+
+    std::atomic<int64_t> m_value{0};
+};
+
+// Observations are in seconds and summed in whole microseconds.
+class Histogram final : public Metric {
+public:
+    Histogram(char const* name, char const* help, std::initializer_list<double> bounds, char const* labels = "");
+
+    void observe(double seconds);
+
+private:
+    char const* type() const override {
+        return "histogram";
+    }
+    void write(std::string& out) const override;
+
+    std::vector<double> m_bounds;
+    // One per bound plus +Inf; not cumulative until written.
+    std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+    std::atomic<uint64_t> m_sumMicros{0};
+};
+
+// Observes the time until it goes out of scope.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram) : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+        m_histogram.observe(elapsed.count());
+    }
+
+    ScopedTimer(ScopedTimer const&) = delete;
+    ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+private:
+    Histogram& m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Every registered metric, ending with "# EOF".
+std::string formatOpenMetrics();
@@ -0,0 +1,90 @@
+#include "RecordPager.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+RecordPager::RecordPager(size_t pageSize, size_t readAhead, size_t keepAround)
+    : m_pageSize(std::max<size_t>(pageSize, 1)), m_readAhead(readAhead), m_keepAround(keepAround) {}
+
+size_t RecordPager::rowCount() const {
+    if (m_total) return *m_total;
+    return m_knownPages * m_pageSize;
+}
+
+RecordRow const* RecordPager::row(size_t index) const {
+    auto page = m_unpaged ? 0 : index / m_pageSize;
+    auto offset = m_unpaged ? index : index % m_pageSize;
+    auto it = m_pages.find(page);
+    if (it == m_pages.end() || it->second.state != State::Loaded || offset >= it->second.rows.size()) return nullptr;
+    return &it->second.rows[offset];
+}
+
+bool RecordPager::failed(size_t index) const {
+    auto it = m_pages.find(m_unpaged ? 0 : index / m_pageSize);
+    return it != m_pages.end() && it->second.state == State::Failed;
+}
+
+size_t RecordPager::residentRows() const {
+    size_t rows = 0;
+    for (auto const& [index, page] : m_pages) rows += page.rows.size();
+    return rows;
+}
+
+std::vector<size_t> RecordPager::update(size_t firstRow, size_t lastRow, double now) {
+    std::vector<size_t> wanted;
+    if (m_unpaged) return wanted;
+
+    auto count = rowCount();
+    if (count == 0) return wanted;
+    auto lastPossible = (count - 1) / m_pageSize;
+    auto firstPage = std::min(firstRow / m_pageSize, lastPossible);
+    auto lastPage = std::min(lastRow / m_pageSize + m_readAhead, lastPossible);
+
+    std::erase_if(m_pages, [&](auto const& entry) {
+        auto const& [index, page] = entry;
+        if (page.state == State::Loading) return false;
+        return index + m_keepAround < firstPage || index > lastPage + m_keepAround;
+    });
+
+    for (auto page = firstPage; page <= lastPage; ++page) {
+        auto [it, inserted] = m_pages.try_emplace(page);
+        if (!inserted && it->second.state == State::Failed && now >= it->second.retryAt) {
+            it->second.state = State::Loading;
+            inserted = true;
+        }
+        if (inserted) wanted.push_back(page);
+    }
+    return wanted;
+}
+
+void RecordPager::onPage(size_t page, RecordsPage data) {
+    if (!data.paged) {
+        m_unpaged = true;
+        m_total = data.rows.size();
+        m_pages.clear();
+        m_pages[0] = {State::Loaded, std::move(data.rows)};
+        return;
+    }
+
+    if (data.total) m_total = data.total;
+    if (data.pages) m_knownPages = std::max<size_t>(*data.pages, 1);
+
+    auto rows = data.rows.size();
+    if (rows < m_pageSize || (data.pages && page + 1 >= *data.pages)) {
+        // A short or final page ends the list.
+        if (!m_total) m_total = page * m_pageSize + rows;
+    }
+    else if (!data.pages) {
+        m_knownPages = std::max(m_knownPages, page + 2);
+    }
+    m_pages[page] = {State::Loaded, std::move(data.rows)};
+}
+
+void RecordPager::onPageFailed(size_t page, double now) {
+    auto& failed = m_pages[page];
+    failed.state = State::Failed;
+    failed.rows.clear();
+    auto delay = RETRY_DELAY * std::exp2(static_cast<double>(failed.failures));
+    failed.retryAt = now + std::min(delay, RETRY_DELAY_MAX);
+    ++failed.failures;
+}
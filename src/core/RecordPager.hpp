@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ResponseReducer.hpp"
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <vector>
+
+// Tracks which pages of a long, paged list are loaded for a scrolling view.
+// Only pages near what's on screen stay resident, so memory is bounded by
+// the window, not by the length of the list.
+//
+// Until the end of the list is seen, rowCount() includes one page of
+// placeholders past the last loaded page, so the view can scroll into it.
+class RecordPager {
+public:
+    // A failed page in view is requested again after RETRY_DELAY seconds,
+    // doubling with every further failure up to RETRY_DELAY_MAX.
+    static constexpr double RETRY_DELAY = 2.0;
+    static constexpr double RETRY_DELAY_MAX = 30.0;
+
+    // `readAhead` pages past the visible ones are fetched early; loaded pages
+    // more than `keepAround` pages from the visible ones are dropped.
+    RecordPager(size_t pageSize, size_t readAhead, size_t keepAround);
+
+    size_t pageSize() const {
+        return m_pageSize;
+    }
+    size_t rowCount() const;
+    // True once the exact number of rows is known.
+    bool complete() const {
+        return m_total.has_value();
+    }
+    // nullptr while the row's page isn't loaded.
+    RecordRow const* row(size_t index) const;
+    bool failed(size_t index) const;
+    size_t residentRows() const;
+
+    // Takes the rows on screen and returns the pages (from 0) to request,
+    // marking them loading, failed pages whose retry is due included. `now`
+    // is any monotonic clock in seconds, the same one onPageFailed() gets.
+    std::vector<size_t> update(size_t firstRow, size_t lastRow, double now);
+    void onPage(size_t page, RecordsPage data);
+    void onPageFailed(size_t page, double now);
+
+private:
+    enum class State { Loading, Loaded, Failed };
+    struct Page {
+        State state = State::Loading;
+        std::vector<RecordRow> rows;
+        // Failed pages only.
+        unsigned failures = 0;
+        double retryAt = 0;
+    };
+
+    std::map<size_t, Page> m_pages;
+    size_t m_pageSize;
+    size_t m_readAhead;
+    size_t m_keepAround;
+    std::optional<size_t> m_total;
+    size_t m_knownPages = 1;
+    // The API returned the whole list as one array; it lives in page 0.
+    bool m_unpaged = false;
+};
@@ -0,0 +1,196 @@
+#include "ResponseReducer.hpp"
+#include "JsonReader.hpp"
+#include "LevelKey.hpp"
+
+#include <algorithm>
+
+std::string LevelSummary::display() const {
+    if (names.empty()) return "";
+    if (names.size() == 1) return names[0];
+    return names[0] + " & " + names[1];
+}
+
+void addVerifierName(LevelSummary& summary, std::string name) {
+    if (name.empty()) name = "Unknown";
+    if (std::ranges::find(summary.names, name) == summary.names.end()) {
+        summary.names.push_back(std::move(name));
+    }
+}
+
+// Reads a member of a known type, treating any other type as absent.
+template <class T>
+static bool readOrSkip(JsonReader& reader, T& out) {
+    return readJsonField(reader, out) || reader.skip();
+}
+
+// The display name of a "submitted_by" user: global name, else username.
+static bool readUserName(JsonReader& reader, std::string& name) {
+    std::string globalName, username;
+    bool ok = reader.readObject([&](std::string_view key) {
+        if (key == "global_name") return readOrSkip(reader, globalName);
+        if (key == "username") return readOrSkip(reader, username);
+        return reader.skip();
+    });
+    name = globalName.empty() ? std::move(username) : std::move(globalName);
+    return ok;
+}
+
+static bool readSubmitter(JsonReader& reader, LevelSummary& summary) {
+    if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+    std::string name;
+    bool ok = readUserName(reader, name);
+    if (ok) addVerifierName(summary, std::move(name));
+    return ok;
+}
+
+static bool readVerification(JsonReader& reader, LevelSummary& summary) {
+    if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+    return reader.readObject([&](std::string_view key) {
+        if (key == "video_url" && summary.video.empty()) return readOrSkip(reader, summary.video);
+        if (key == "submitted_by") return readSubmitter(reader, summary);
+        return reader.skip();
+    });
+}
+
+std::optional<LevelSummary> reduceLevelResponse(std::string_view json) {
+    JsonReader reader(json);
+    LevelSummary summary;
+    bool ok = reader.readObject([&](std::string_view key) {
+        if (key == "legacy") return readOrSkip(reader, summary.legacy);
+        if (key == "verifications") {
+            if (reader.peek() != JsonReader::Kind::Array) return reader.skip();
+            return reader.readArray([&] { return readVerification(reader, summary); });
+        }
+        return reader.skip();
+    });
+    if (!ok || !reader.atEnd()) return std::nullopt;
+    return summary;
+}
+
+std::optional<std::vector<SnapshotEntry>> reduceListResponse(std::string_view json) {
+    JsonReader reader(json);
+    std::vector<SnapshotEntry> entries;
+    bool ok = reader.readArray([&] {
+        if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+        int64_t id = 0, position = 0;
+        bool duo = false, legacy = false;
+        bool read = reader.readObject([&](std::string_view key) {
+            if (key == "level_id") return readOrSkip(reader, id);
+            if (key == "position") return readOrSkip(reader, position);
+            if (key == "two_player") return readOrSkip(reader, duo);
+            if (key == "legacy") return readOrSkip(reader, legacy);
+            return reader.skip();
+        });
+        if (read && id > 0 && id <= INT32_MAX) {
+            uint32_t flags = (duo ? SNAPSHOT_TWO_PLAYER : 0u) | (legacy ? SNAPSHOT_LEGACY : 0u);
+            entries.push_back({packLevelKey(static_cast<int>(id), duo), {static_cast<uint32_t>(position), flags}});
+        }
+        return read;
+    });
+    if (!ok || !reader.atEnd()) return std::nullopt;
+    return entries;
+}
+
+static bool readChangedLevel(JsonReader& reader, ChangelogEntry& entry) {
+    if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+    int64_t id = 0;
+    bool ok = reader.readObject([&](std::string_view key) {
+        if (key == "level_id") return readOrSkip(reader, id);
+        return reader.skip();
+    });
+    if (ok && id > 0 && id <= INT32_MAX) entry.levelIDs.push_back(static_cast<int>(id));
+    return ok;
+}
+
+static bool readChanges(JsonReader& reader, std::vector<ChangelogEntry>& entries) {
+    return reader.readArray([&] {
+        if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+        ChangelogEntry entry;
+        bool ok = reader.readObject([&](std::string_view key) {
+            if (key == "created_at") return readOrSkip(reader, entry.createdAt);
+            // A move or placement touches the level itself and its neighbours.
+            if (key == "affected_level" || key == "level_above" || key == "level_below" || key == "level") {
+                return readChangedLevel(reader, entry);
+            }
+            return reader.skip();
+        });
+        if (ok) entries.push_back(std::move(entry));
+        return ok;
+    });
+}
+
+std::optional<std::vector<ChangelogEntry>> reduceChangelog(std::string_view json) {
+    JsonReader reader(json);
+    std::vector<ChangelogEntry> entries;
+    bool ok;
+    if (reader.peek() == JsonReader::Kind::Array) {
+        ok = readChanges(reader, entries);
+    }
+    else {
+        ok = reader.readObject([&](std::string_view key) {
+            if (key == "data" && reader.peek() == JsonReader::Kind::Array) return readChanges(reader, entries);
+            return reader.skip();
+        });
+    }
+    if (!ok || !reader.atEnd()) return std::nullopt;
+    return entries;
+}
+
+static bool readRecords(JsonReader& reader, std::vector<RecordRow>& rows) {
+    return reader.readArray([&] {
+        if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+        RecordRow row;
+        bool ok = reader.readObject([&](std::string_view key) {
+            if (key == "mobile") return readOrSkip(reader, row.mobile);
+            if (key == "submitted_by" && reader.peek() == JsonReader::Kind::Object) {
+                return readUserName(reader, row.player);
+            }
+            return reader.skip();
+        });
+        if (row.player.empty()) row.player = "Unknown";
+        if (ok) rows.push_back(std::move(row));
+        return ok;
+    });
+}
+
+std::optional<RecordsPage> reduceRecordsPage(std::string_view json) {
+    JsonReader reader(json);
+    RecordsPage page;
+    bool ok;
+    if (reader.peek() == JsonReader::Kind::Array) {
+        ok = readRecords(reader, page.rows);
+    }
+    else {
+        page.paged = true;
+        ok = reader.readObject([&](std::string_view key) {
+            if (key == "data" && reader.peek() == JsonReader::Kind::Array) return readRecords(reader, page.rows);
+            if (key == "total" || key == "count" || key == "total_count") {
+                int64_t total = 0;
+                if (!readJsonField(reader, total)) return reader.skip();
+                if (total >= 0) page.total = static_cast<size_t>(total);
+                return true;
+            }
+            if (key == "pages" || key == "total_pages") {
+                int64_t pages = 0;
+                if (!readJsonField(reader, pages)) return reader.skip();
+                if (pages >= 0) page.pages = static_cast<size_t>(pages);
+                return true;
+            }
+            return reader.skip();
+        });
+    }
+    if (!ok || !reader.atEnd()) return std::nullopt;
+    return page;
+}
+
+bool reduceCacheFile(std::string_view json, std::function<void(std::string_view, VerifierData)> const& onEntry) {
+    JsonReader reader(json);
+    bool ok = reader.readObject([&](std::string_view key) {
+        if (reader.peek() != JsonReader::Kind::Object) return reader.skip();
+        VerifierData data;
+        if (!readJsonRecord(reader, data)) return false;
+        onEntry(key, std::move(data));
+        return true;
+    });
+    return ok && reader.atEnd();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "SnapshotFile.hpp"
+#include "VerifierData.hpp"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The parts of a level response the mod keeps.
+struct LevelSummary {
+    std::vector<std::string> names;
+    std::string video;
+    bool legacy = false;
+
+    // "A" or "A & B"; empty if nobody verified the level.
+    std::string display() const;
+};
+
+// One change from a list's changelog feed and the levels it touched.
+struct ChangelogEntry {
+    std::string createdAt;
+    std::vector<int> levelIDs;
+};
+
+// One completion from a level's records list.
+struct RecordRow {
+    std::string player;
+    bool mobile = false;
+};
+
+// One page of a level's records. The API may answer with a bare array, which
+// is then the whole list, or a {"data": [...]} envelope with paging totals.
+struct RecordsPage {
+    std::vector<RecordRow> rows;
+    bool paged = false;
+    std::optional<size_t> total; // records across all pages, if given
+    std::optional<size_t> pages; // number of pages, if given
+};
+
+// Adds a verifier name, ignoring duplicates.
+void addVerifierName(LevelSummary& summary, std::string name);
+
+// Single-pass reducers built on JsonReader. They keep only the fields above
+// and skip everything else without materializing it.
+std::optional<LevelSummary> reduceLevelResponse(std::string_view json);
+std::optional<std::vector<SnapshotEntry>> reduceListResponse(std::string_view json);
+// Accepts a bare array of changes or a paginated {"data": [...]} object.
+std::optional<std::vector<ChangelogEntry>> reduceChangelog(std::string_view json);
+std::optional<RecordsPage> reduceRecordsPage(std::string_view json);
+bool reduceCacheFile(std::string_view json, std::function<void(std::string_view, VerifierData)> const& onEntry);
@@ -0,0 +1,61 @@
+#include "RetryBackoff.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+static bool parseInt(std::string_view text, int& out) {
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && end == text.data() + text.size();
+}
+
+// IMF-fixdate, the only form servers may send: "Sun, 06 Nov 1994 08:49:37 GMT".
+static std::optional<long long> parseHttpDate(std::string_view text) {
+    static constexpr std::array<std::string_view, 12> MONTHS = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec",
+    };
+    if (text.size() != 29 || text[3] != ',' || text.substr(25) != " GMT") return std::nullopt;
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+    if (!parseInt(text.substr(5, 2), day) || !parseInt(text.substr(12, 4), year)) return std::nullopt;
+    if (text[19] != ':' || text[22] != ':') return std::nullopt;
+    if (!parseInt(text.substr(17, 2), hour) || !parseInt(text.substr(20, 2), minute) ||
+        !parseInt(text.substr(23, 2), second)) {
+        return std::nullopt;
+    }
+    auto month = std::ranges::find(MONTHS, text.substr(8, 3));
+    if (month == MONTHS.end()) return std::nullopt;
+
+    using namespace std::chrono;
+    year_month_day date{
+        std::chrono::year(year), std::chrono::month(static_cast<unsigned>(month - MONTHS.begin() + 1)),
+        std::chrono::day(static_cast<unsigned>(day))
+    };
+    if (!date.ok() || hour > 23 || minute > 59 || second > 60) return std::nullopt;
+    auto days = sys_days(date).time_since_epoch().count();
+    return static_cast<long long>(days) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+std::optional<double> parseRetryAfter(std::string_view value, long long now) {
+    while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+    while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+    int seconds = 0;
+    if (parseInt(value, seconds)) {
+        if (seconds < 0) return std::nullopt;
+        return static_cast<double>(seconds);
+    }
+    auto date = parseHttpDate(value);
+    if (!date) return std::nullopt;
+    return static_cast<double>(std::max(*date - now, 0LL));
+}
+
+std::optional<double> retryDelay(int attempts, std::optional<double> retryAfter, double jitter) {
+    if (retryAfter) {
+        if (*retryAfter > RETRY_MAX) return std::nullopt;
+        // A little on top, so everyone told the same time doesn't retry at once.
+        return *retryAfter + jitter * RETRY_BASE;
+    }
+    auto backoff = std::min(RETRY_BASE * std::exp2(std::max(attempts - 1, 0)), RETRY_MAX);
+    return backoff / 2 + jitter * backoff / 2;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+// When to retry a rate-limited request. The server's Retry-After wins. Without
+// one, the wait doubles with every attempt from RETRY_BASE up to RETRY_MAX,
+// and a random half of it is jitter, so requests throttled together don't all
+// come back together.
+static constexpr double RETRY_BASE = 1.0;
+static constexpr double RETRY_MAX = 60.0;
+
+// Seconds after `now` (Unix time) that a Retry-After value asks for, as
+// delta-seconds or an HTTP date. nullopt if it is neither.
+std::optional<double> parseRetryAfter(std::string_view value, long long now);
+
+// Seconds to wait after `attempts` tries (from 1), with `jitter` uniform in
+// [0, 1). nullopt if the server wants more than RETRY_MAX, which isn't worth
+// holding a request for.
+std::optional<double> retryDelay(int attempts, std::optional<double> retryAfter, double jitter);
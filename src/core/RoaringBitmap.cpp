@@ -0,0 +1,272 @@
+#include "RoaringBitmap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+static constexpr uint32_t SERIAL_COOKIE_NO_RUNCONTAINER = 12346;
+
+bool RoaringBitmap::Container::contains(uint16_t low) const {
+    if (isBitmap()) return (bitmap[low >> 6] >> (low & 63)) & 1;
+    return std::ranges::binary_search(array, low);
+}
+
+bool RoaringBitmap::Container::add(uint16_t low) {
+    if (isBitmap()) {
+        auto& word = bitmap[low >> 6];
+        auto mask = uint64_t(1) << (low & 63);
+        if (word & mask) return false;
+        word |= mask;
+        ++card;
+        return true;
+    }
+    auto it = std::ranges::lower_bound(array, low);
+    if (it != array.end() && *it == low) return false;
+    array.insert(it, low);
+    ++card;
+    if (card > ARRAY_MAX) toBitmap();
+    return true;
+}
+
+bool RoaringBitmap::Container::remove(uint16_t low) {
+    if (isBitmap()) {
+        auto& word = bitmap[low >> 6];
+        auto mask = uint64_t(1) << (low & 63);
+        if (!(word & mask)) return false;
+        word &= ~mask;
+        --card;
+        normalize();
+        return true;
+    }
+    auto it = std::ranges::lower_bound(array, low);
+    if (it == array.end() || *it != low) return false;
+    array.erase(it);
+    --card;
+    return true;
+}
+
+void RoaringBitmap::Container::toBitmap() {
+    if (isBitmap()) return;
+    bitmap.assign(BITMAP_WORDS, 0);
+    for (auto low : array) bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::normalize() {
+    if (!isBitmap() || card > ARRAY_MAX) return;
+    array.clear();
+    array.reserve(card);
+    for (size_t w = 0; w < bitmap.size(); ++w) {
+        for (uint64_t bits = bitmap[w]; bits; bits &= bits - 1) {
+            array.push_back(static_cast<uint16_t>(w * 64 + std::countr_zero(bits)));
+        }
+    }
+    bitmap.clear();
+    bitmap.shrink_to_fit();
+}
+
+RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) {
+    auto it = std::ranges::lower_bound(m_containers, key, {}, &Container::key);
+    return it != m_containers.end() && it->key == key ? &*it : nullptr;
+}
+
+RoaringBitmap::Container const* RoaringBitmap::find(uint16_t key) const {
+    auto it = std::ranges::lower_bound(m_containers, key, {}, &Container::key);
+    return it != m_containers.end() && it->key == key ? &*it : nullptr;
+}
+
+void RoaringBitmap::add(uint32_t value) {
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto it = std::ranges::lower_bound(m_containers, key, {}, &Container::key);
+    if (it == m_containers.end() || it->key != key) {
+        it = m_containers.insert(it, Container(key));
+    }
+    it->add(static_cast<uint16_t>(value));
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto it = std::ranges::lower_bound(m_containers, key, {}, &Container::key);
+    if (it == m_containers.end() || it->key != key) return;
+    if (it->remove(static_cast<uint16_t>(value)) && it->card == 0) {
+        m_containers.erase(it);
+    }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    auto c = find(static_cast<uint16_t>(value >> 16));
+    return c && c->contains(static_cast<uint16_t>(value));
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (auto const& c : m_containers) total += c.card;
+    return total;
+}
+
+bool RoaringBitmap::operator==(RoaringBitmap const& other) const {
+    if (m_containers.size() != other.m_containers.size()) return false;
+    for (size_t i = 0; i < m_containers.size(); ++i) {
+        auto const& a = m_containers[i];
+        auto const& b = other.m_containers[i];
+        if (a.key != b.key || a.card != b.card || a.array != b.array || a.bitmap != b.bitmap) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RoaringBitmap::Container RoaringBitmap::combine(Container const& a, Container const& b, Op op) {
+    Container out(a.key);
+    if (!a.isBitmap() && !b.isBitmap()) {
+        auto dst = std::back_inserter(out.array);
+        switch (op) {
+            case Op::And: std::ranges::set_intersection(a.array, b.array, dst); break;
+            case Op::Or: std::ranges::set_union(a.array, b.array, dst); break;
+            case Op::AndNot: std::ranges::set_difference(a.array, b.array, dst); break;
+        }
+        out.card = static_cast<uint32_t>(out.array.size());
+        if (out.card > ARRAY_MAX) out.toBitmap();
+        return out;
+    }
+
+    Container lhs = a, rhs = b;
+    lhs.toBitmap();
+    rhs.toBitmap();
+    out.bitmap.resize(BITMAP_WORDS);
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        switch (op) {
+            case Op::And: out.bitmap[w] = lhs.bitmap[w] & rhs.bitmap[w]; break;
+            case Op::Or: out.bitmap[w] = lhs.bitmap[w] | rhs.bitmap[w]; break;
+            case Op::AndNot: out.bitmap[w] = lhs.bitmap[w] & ~rhs.bitmap[w]; break;
+        }
+        out.card += std::popcount(out.bitmap[w]);
+    }
+    out.normalize();
+    return out;
+}
+
+void RoaringBitmap::apply(RoaringBitmap const& other, Op op) {
+    std::vector<Container> result;
+    result.reserve(m_containers.size() + (op == Op::Or ? other.m_containers.size() : 0));
+
+    auto a = m_containers.begin();
+    auto b = other.m_containers.begin();
+    while (a != m_containers.end() || b != other.m_containers.end()) {
+        if (b == other.m_containers.end() || (a != m_containers.end() && a->key < b->key)) {
+            if (op != Op::And) result.push_back(std::move(*a));
+            ++a;
+        }
+        else if (a == m_containers.end() || b->key < a->key) {
+            if (op == Op::Or) result.push_back(*b);
+            ++b;
+        }
+        else {
+            auto merged = combine(*a, *b, op);
+            if (merged.card) result.push_back(std::move(merged));
+            ++a;
+            ++b;
+        }
+    }
+    m_containers = std::move(result);
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(RoaringBitmap const& other) {
+    apply(other, Op::And);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(RoaringBitmap const& other) {
+    apply(other, Op::Or);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator-=(RoaringBitmap const& other) {
+    apply(other, Op::AndNot);
+    return *this;
+}
+
+template <class T>
+static void put(std::vector<uint8_t>& out, T value) {
+    auto at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+template <class T>
+static bool take(std::span<uint8_t const>& in, T& value) {
+    if (in.size() < sizeof(T)) return false;
+    std::memcpy(&value, in.data(), sizeof(T));
+    in = in.subspan(sizeof(T));
+    return true;
+}
+
+void RoaringBitmap::serialize(std::vector<uint8_t>& out) const {
+    auto count = static_cast<uint32_t>(m_containers.size());
+    put(out, SERIAL_COOKIE_NO_RUNCONTAINER);
+    put(out, count);
+    for (auto const& c : m_containers) {
+        put(out, c.key);
+        put(out, static_cast<uint16_t>(c.card - 1));
+    }
+
+    // Offsets are relative to the start of this bitmap.
+    uint32_t offset = 8 + count * 8;
+    for (auto const& c : m_containers) {
+        put(out, offset);
+        offset += c.isBitmap() ? BITMAP_WORDS * 8 : c.card * 2;
+    }
+    for (auto const& c : m_containers) {
+        if (c.isBitmap()) {
+            for (auto word : c.bitmap) put(out, word);
+        }
+        else {
+            for (auto low : c.array) put(out, low);
+        }
+    }
+}
+
+std::optional<RoaringBitmap> RoaringBitmap::deserialize(std::span<uint8_t const>& in) {
+    uint32_t cookie, count;
+    if (!take(in, cookie) || cookie != SERIAL_COOKIE_NO_RUNCONTAINER) return std::nullopt;
+    if (!take(in, count) || count > 0x10000) return std::nullopt;
+
+    RoaringBitmap out;
+    out.m_containers.resize(count);
+    for (auto& c : out.m_containers) {
+        uint16_t cardMinusOne;
+        if (!take(in, c.key) || !take(in, cardMinusOne)) return std::nullopt;
+        c.card = cardMinusOne + 1u;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t offset;
+        if (!take(in, offset)) return std::nullopt;
+    }
+
+    uint16_t prevKey = 0;
+    for (auto& c : out.m_containers) {
+        if (&c != out.m_containers.data() && c.key <= prevKey) return std::nullopt;
+        prevKey = c.key;
+
+        if (c.card > ARRAY_MAX) {
+            c.bitmap.resize(BITMAP_WORDS);
+            uint32_t actual = 0;
+            for (auto& word : c.bitmap) {
+                if (!take(in, word)) return std::nullopt;
+                actual += std::popcount(word);
+            }
+            if (actual != c.card) return std::nullopt;
+        }
+        else {
+            c.array.resize(c.card);
+            for (auto& low : c.array) {
+                if (!take(in, low)) return std::nullopt;
+            }
+            if (std::ranges::adjacent_find(c.array, std::greater_equal{}) != c.array.end()) {
+                return std::nullopt;
+            }
+        }
+    }
+    return out;
+}
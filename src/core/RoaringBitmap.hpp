@@ -0,0 +1,101 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Compressed set of uint32 values. Values are split by their high 16 bits
+// into containers that are either a sorted uint16 array (sparse) or a 2^16
+// bit bitmap (dense, more than 4096 values). Run containers are not
+// implemented; level IDs are too scattered for them to pay off.
+//
+// serialize() writes the portable Roaring format without runs (cookie
+// 12346), so files can be inspected with any Roaring implementation.
+class RoaringBitmap {
+public:
+    void add(uint32_t value);
+    void remove(uint32_t value);
+    bool contains(uint32_t value) const;
+
+    uint64_t cardinality() const;
+    bool empty() const {
+        return m_containers.empty();
+    }
+    void clear() {
+        m_containers.clear();
+    }
+
+    RoaringBitmap& operator&=(RoaringBitmap const& other);
+    RoaringBitmap& operator|=(RoaringBitmap const& other);
+    // Removes every value present in `other` (and-not).
+    RoaringBitmap& operator-=(RoaringBitmap const& other);
+
+    friend RoaringBitmap operator&(RoaringBitmap lhs, RoaringBitmap const& rhs) {
+        return lhs &= rhs;
+    }
+    friend RoaringBitmap operator|(RoaringBitmap lhs, RoaringBitmap const& rhs) {
+        return lhs |= rhs;
+    }
+    friend RoaringBitmap operator-(RoaringBitmap lhs, RoaringBitmap const& rhs) {
+        return lhs -= rhs;
+    }
+
+    bool operator==(RoaringBitmap const& other) const;
+
+    template <class F>
+    void forEach(F&& fn) const {
+        for (auto const& c : m_containers) {
+            uint32_t high = static_cast<uint32_t>(c.key) << 16;
+            if (c.isBitmap()) {
+                for (size_t w = 0; w < c.bitmap.size(); ++w) {
+                    for (uint64_t bits = c.bitmap[w]; bits; bits &= bits - 1) {
+                        fn(high | static_cast<uint32_t>(w * 64 + std::countr_zero(bits)));
+                    }
+                }
+            }
+            else {
+                for (auto low : c.array) fn(high | low);
+            }
+        }
+    }
+
+    void serialize(std::vector<uint8_t>& out) const;
+    // Reads one bitmap from the front of `in` and advances past it.
+    static std::optional<RoaringBitmap> deserialize(std::span<uint8_t const>& in);
+
+private:
+    static constexpr size_t ARRAY_MAX = 4096;
+    static constexpr size_t BITMAP_WORDS = 1024;
+
+    struct Container {
+        explicit Container(uint16_t high = 0) : key(high) {}
+
+        uint16_t key;
+        uint32_t card = 0;
+        std::vector<uint16_t> array;
+        std::vector<uint64_t> bitmap;
+
+        bool isBitmap() const {
+            return !bitmap.empty();
+        }
+        bool contains(uint16_t low) const;
+        bool add(uint16_t low);
+        bool remove(uint16_t low);
+        void toBitmap();
+        // Switches to the cheaper representation for the current cardinality.
+        void normalize();
+    };
+
+    enum class Op { And, Or, AndNot };
+
+    static Container combine(Container const& a, Container const& b, Op op);
+    void apply(RoaringBitmap const& other, Op op);
+
+    Container* find(uint16_t key);
+    Container const* find(uint16_t key) const;
+
+    std::vector<Container> m_containers; // sorted by key
+};
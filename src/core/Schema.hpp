@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+// Compile-time field list for a plain struct. Codecs walk it instead of
+// naming every member by hand:
+//
+//   template <>
+//   struct Schema<Foo> {
+//       static constexpr std::tuple fields{
+//           field("bar", &Foo::bar),
+//       };
+//   };
+
+template <class T, class M>
+struct Field {
+    using Type = M;
+
+    std::string_view name;
+    M T::* member;
+};
+
+template <class T, class M>
+constexpr Field<T, M> field(std::string_view name, M T::* member) {
+    return {name, member};
+}
+
+template <class T>
+struct Schema;
+
+template <class T>
+concept HasSchema = requires { Schema<T>::fields; };
+
+template <HasSchema T, class F>
+constexpr void forEachField(F&& fn) {
+    std::apply([&](auto const&... f) { (fn(f), ...); }, Schema<T>::fields);
+}
+
+// Calls fn with the field named `name`. Returns false if there is none.
+template <HasSchema T, class F>
+constexpr bool visitField(std::string_view name, F&& fn) {
+    bool found = false;
+    forEachField<T>([&](auto const& f) {
+        if (!found && f.name == name) {
+            found = true;
+            fn(f);
+        }
+    });
+    return found;
+}
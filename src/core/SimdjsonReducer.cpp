@@ -0,0 +1,182 @@
+#include "SimdjsonReducer.hpp"
+
+#ifdef VERIFIER_HAVE_SIMDJSON
+
+#include "LevelKey.hpp"
+
+#include <simdjson.h>
+
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <string>
+
+namespace ondemand = simdjson::ondemand;
+
+// Parsers keep their buffers between documents.
+static ondemand::parser& parser() {
+    static thread_local ondemand::parser s_parser;
+    return s_parser;
+}
+
+// Reads a value of the field's type. Any other type leaves `out` alone and
+// the value is skipped, as readJsonField() does; false only if the JSON is
+// malformed.
+static bool readValue(ondemand::value value, bool& out) {
+    ondemand::json_type type;
+    if (value.type().get(type)) return false;
+    if (type != ondemand::json_type::boolean) return true;
+    return !value.get_bool().get(out);
+}
+
+static bool readValue(ondemand::value value, std::string& out) {
+    ondemand::json_type type;
+    if (value.type().get(type)) return false;
+    if (type != ondemand::json_type::string) return true;
+    std::string_view text;
+    if (value.get_string().get(text)) return false;
+    out = text;
+    return true;
+}
+
+template <std::signed_integral T>
+static bool readValue(ondemand::value value, T& out) {
+    ondemand::json_type type;
+    if (value.type().get(type)) return false;
+    if (type != ondemand::json_type::number) return true;
+    // Through from_chars like JsonReader::readInt(), so a fraction or
+    // exponent is dropped the same way and an out-of-range number is absent.
+    std::string_view token = value.raw_json_token();
+    int64_t number;
+    auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), number);
+    if (ec == std::errc()) out = static_cast<T>(number);
+    return true;
+}
+
+// Calls fn(key, value) for each member of an object value; non-objects are
+// skipped. fn returns false on malformed JSON.
+template <class F>
+static bool forEachMember(ondemand::value value, F&& fn) {
+    ondemand::json_type type;
+    if (value.type().get(type)) return false;
+    if (type != ondemand::json_type::object) return true;
+    ondemand::object object;
+    if (value.get_object().get(object)) return false;
+    for (auto member : object) {
+        std::string_view key;
+        ondemand::value child;
+        if (member.unescaped_key().get(key) || member.value().get(child)) return false;
+        if (!fn(key, child)) return false;
+    }
+    return true;
+}
+
+template <class F>
+static bool forEachElement(ondemand::value value, F&& fn) {
+    ondemand::json_type type;
+    if (value.type().get(type)) return false;
+    if (type != ondemand::json_type::array) return true;
+    ondemand::array array;
+    if (value.get_array().get(array)) return false;
+    for (auto element : array) {
+        ondemand::value child;
+        if (element.get(child) || !fn(child)) return false;
+    }
+    return true;
+}
+
+static bool readVerification(ondemand::value value, LevelSummary& summary) {
+    return forEachMember(value, [&](std::string_view key, ondemand::value child) {
+        if (key == "video_url" && summary.video.empty()) return readValue(child, summary.video);
+        if (key != "submitted_by") return true;
+
+        ondemand::json_type type;
+        if (child.type().get(type)) return false;
+        if (type != ondemand::json_type::object) return true;
+        std::string globalName, username;
+        bool ok = forEachMember(child, [&](std::string_view userKey, ondemand::value user) {
+            if (userKey == "global_name") return readValue(user, globalName);
+            if (userKey == "username") return readValue(user, username);
+            return true;
+        });
+        if (ok) addVerifierName(summary, globalName.empty() ? std::move(username) : std::move(globalName));
+        return ok;
+    });
+}
+
+std::optional<LevelSummary> simdjsonLevelResponse(std::string_view json) {
+    simdjson::padded_string padded(json);
+    ondemand::document doc;
+    ondemand::value root;
+    if (parser().iterate(padded).get(doc) || doc.get_value().get(root)) return std::nullopt;
+
+    ondemand::json_type type;
+    if (root.type().get(type) || type != ondemand::json_type::object) return std::nullopt;
+    LevelSummary summary;
+    bool ok = forEachMember(root, [&](std::string_view key, ondemand::value value) {
+        if (key == "legacy") return readValue(value, summary.legacy);
+        if (key == "verifications") {
+            return forEachElement(value, [&](ondemand::value v) { return readVerification(v, summary); });
+        }
+        return true;
+    });
+    if (!ok || !doc.at_end()) return std::nullopt;
+    return summary;
+}
+
+std::optional<std::vector<SnapshotEntry>> simdjsonListResponse(std::string_view json) {
+    simdjson::padded_string padded(json);
+    ondemand::document doc;
+    ondemand::value root;
+    if (parser().iterate(padded).get(doc) || doc.get_value().get(root)) return std::nullopt;
+
+    ondemand::json_type type;
+    if (root.type().get(type) || type != ondemand::json_type::array) return std::nullopt;
+    std::vector<SnapshotEntry> entries;
+    bool ok = forEachElement(root, [&](ondemand::value level) {
+        int64_t id = 0, position = 0;
+        bool duo = false, legacy = false, isObject = false;
+        bool read = forEachMember(level, [&](std::string_view key, ondemand::value value) {
+            isObject = true;
+            if (key == "level_id") return readValue(value, id);
+            if (key == "position") return readValue(value, position);
+            if (key == "two_player") return readValue(value, duo);
+            if (key == "legacy") return readValue(value, legacy);
+            return true;
+        });
+        if (read && isObject && id > 0 && id <= INT32_MAX) {
+            uint32_t flags = (duo ? SNAPSHOT_TWO_PLAYER : 0u) | (legacy ? SNAPSHOT_LEGACY : 0u);
+            entries.push_back({packLevelKey(static_cast<int>(id), duo), {static_cast<uint32_t>(position), flags}});
+        }
+        return read;
+    });
+    if (!ok || !doc.at_end()) return std::nullopt;
+    return entries;
+}
+
+bool simdjsonCacheFile(std::string_view json, std::function<void(std::string_view, VerifierData)> const& onEntry) {
+    simdjson::padded_string padded(json);
+    ondemand::document doc;
+    ondemand::value root;
+    if (parser().iterate(padded).get(doc) || doc.get_value().get(root)) return false;
+
+    ondemand::json_type type;
+    if (root.type().get(type) || type != ondemand::json_type::object) return false;
+    bool ok = forEachMember(root, [&](std::string_view key, ondemand::value value) {
+        ondemand::json_type valueType;
+        if (value.type().get(valueType)) return false;
+        if (valueType != ondemand::json_type::object) return true;
+        VerifierData data;
+        bool read = forEachMember(value, [&](std::string_view field, ondemand::value member) {
+            bool fieldOk = true;
+            visitField<VerifierData>(field, [&](auto const& f) { fieldOk = readValue(member, data.*f.member); });
+            return fieldOk;
+        });
+        if (!read) return false;
+        onEntry(key, std::move(data));
+        return true;
+    });
+    return ok && doc.at_end();
+}
+
+#endif
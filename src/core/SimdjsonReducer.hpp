@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ResponseReducer.hpp"
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// The ResponseReducer.hpp reducers again, on simdjson's on-demand API. Only
+// built when simdjson is linked (VERIFIER_HAVE_SIMDJSON): the mod's simdjson
+// backend, and the host tools when CMake finds the library. Same results as
+// the streaming reducers, checked by verifier-jsonbench.
+//
+// simdjson reads up to SIMDJSON_PADDING bytes past the end of its input, so
+// each call first copies `json` into a padded buffer. Skipped values are only
+// checked for structure, so a bad literal there (`tru`) isn't an error as it
+// is for JsonReader.
+
+#ifdef VERIFIER_HAVE_SIMDJSON
+std::optional<LevelSummary> simdjsonLevelResponse(std::string_view json);
+std::optional<std::vector<SnapshotEntry>> simdjsonListResponse(std::string_view json);
+bool simdjsonCacheFile(std::string_view json, std::function<void(std::string_view, VerifierData)> const& onEntry);
+#endif
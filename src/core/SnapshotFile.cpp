@@ -0,0 +1,70 @@
+#include "SnapshotFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+std::optional<SnapshotView> SnapshotView::parse(std::span<uint8_t const> bytes) {
+    if (bytes.size() < sizeof(SnapshotHeader)) return std::nullopt;
+    if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(SnapshotHeader) != 0) return std::nullopt;
+
+    auto header = reinterpret_cast<SnapshotHeader const*>(bytes.data());
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION) return std::nullopt;
+
+    size_t slots = EytzingerIndex::slots(header->count);
+    size_t expected = sizeof(SnapshotHeader) + 2 * slots * sizeof(uint32_t) + header->recordBytes;
+    if (bytes.size() != expected) return std::nullopt;
+    if (header->recordBytes != header->count * sizeof(SnapshotRecord)) return std::nullopt;
+
+    auto keys = reinterpret_cast<uint32_t const*>(bytes.data() + sizeof(SnapshotHeader));
+    auto offsets = keys + slots;
+
+    SnapshotView view;
+    view.m_header = header;
+    view.m_records = reinterpret_cast<uint8_t const*>(offsets + slots);
+    view.m_index = EytzingerIndex(keys, offsets, header->count);
+    return view;
+}
+
+SnapshotRecord const* SnapshotView::find(uint32_t key) const {
+    auto offset = m_index.find(key);
+    if (offset == EytzingerIndex::npos || offset + sizeof(SnapshotRecord) > m_header->recordBytes) {
+        return nullptr;
+    }
+    return reinterpret_cast<SnapshotRecord const*>(m_records + offset);
+}
+
+std::vector<uint8_t> encodeSnapshot(std::vector<SnapshotEntry> entries, int64_t syncedAt) {
+    std::ranges::stable_sort(entries, {}, &SnapshotEntry::key);
+    auto dupes = std::ranges::unique(entries, {}, &SnapshotEntry::key);
+    entries.erase(dupes.begin(), dupes.end());
+
+    std::vector<std::pair<uint32_t, uint32_t>> sorted;
+    sorted.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        sorted.emplace_back(entries[i].key, static_cast<uint32_t>(i * sizeof(SnapshotRecord)));
+    }
+
+    SnapshotHeader header{
+        SNAPSHOT_MAGIC, SNAPSHOT_VERSION,
+        static_cast<uint32_t>(entries.size()),
+        static_cast<uint32_t>(entries.size() * sizeof(SnapshotRecord)),
+        syncedAt
+    };
+    size_t slots = EytzingerIndex::slots(entries.size());
+    std::vector<uint32_t> keys(slots), offsets(slots);
+    EytzingerIndex::build(sorted, keys.data(), offsets.data());
+
+    std::vector<uint8_t> out(sizeof(header) + 2 * slots * sizeof(uint32_t) + header.recordBytes);
+    auto dst = out.data();
+    std::memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    std::memcpy(dst, keys.data(), slots * sizeof(uint32_t));
+    dst += slots * sizeof(uint32_t);
+    std::memcpy(dst, offsets.data(), slots * sizeof(uint32_t));
+    dst += slots * sizeof(uint32_t);
+    for (auto const& e : entries) {
+        std::memcpy(dst, &e.record, sizeof(SnapshotRecord));
+        dst += sizeof(SnapshotRecord);
+    }
+    return out;
+}
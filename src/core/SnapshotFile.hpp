@@ -0,0 +1,69 @@
+#pragma once
+
+#include "EytzingerIndex.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// On-disk layout of a bulk list snapshot, little-endian and 4-byte aligned so
+// it can be used straight out of a mapped file:
+//
+//   SnapshotHeader
+//   uint32_t keys[count + 1]      Eytzinger order, see EytzingerIndex
+//   uint32_t offsets[count + 1]   byte offset of each key's record
+//   SnapshotRecord records[count]
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x31534c56; // "VLS1"
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+enum SnapshotFlags : uint32_t {
+    SNAPSHOT_LEGACY = 1u << 0,
+    SNAPSHOT_TWO_PLAYER = 1u << 1,
+};
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t recordBytes;
+    int64_t syncedAt;
+};
+
+struct SnapshotRecord {
+    uint32_t position;
+    uint32_t flags;
+};
+
+struct SnapshotEntry {
+    uint32_t key;
+    SnapshotRecord record;
+};
+
+static_assert(sizeof(SnapshotHeader) == 24);
+static_assert(sizeof(SnapshotRecord) == 8);
+
+class SnapshotView {
+public:
+    // Validates the header and section sizes; the bytes must outlive the view.
+    static std::optional<SnapshotView> parse(std::span<uint8_t const> bytes);
+
+    SnapshotRecord const* find(uint32_t key) const;
+
+    int64_t syncedAt() const {
+        return m_header->syncedAt;
+    }
+
+    size_t size() const {
+        return m_index.size();
+    }
+
+private:
+    SnapshotHeader const* m_header = nullptr;
+    uint8_t const* m_records = nullptr;
+    EytzingerIndex m_index;
+};
+
+// Sorts `entries` by key (keeping the first of any duplicates) and encodes them.
+std::vector<uint8_t> encodeSnapshot(std::vector<SnapshotEntry> entries, int64_t syncedAt);
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "CacheFile.hpp"
+#include "VerifierData.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+
+// The verifier cache's life on disk, around a TtlCache of VerifierData whose
+// persistence holds the JSON cache file (see CacheFile.hpp):
+//
+//   open()      reads the file; readTail() then parses it a slice at a time,
+//               hottest entries first. Until it's done, loading() is true
+//               and a miss may only mean the entry hasn't been read yet.
+//   save()      writes memory hottest first, then whatever of the tail is
+//               still unread, copied as is, so saving never forces the rest
+//               of the load.
+//   dehydrate() drops memory once the file holds all of it, saving first
+//               if there's time; dehydrated() says the next user has to
+//               open() again.
+//
+// Changes go through here so the unread tail and the dirty flag stay right;
+// lookups go straight to cache(). Shared by the mod and the host tools.
+template <class Cache>
+class StagedCache {
+public:
+    enum class TailState { Loading, Done, Malformed };
+
+    StagedCache() = default;
+    explicit StagedCache(Cache cache) : m_cache(std::move(cache)) {}
+
+    Cache& cache() {
+        return m_cache;
+    }
+    Cache const& cache() const {
+        return m_cache;
+    }
+
+    // Reads the file for readTail(), on top of what memory already holds.
+    // False if there is no file.
+    bool open() {
+        m_dehydrated = false;
+        m_tail.reset();
+        m_erased.clear();
+        auto text = m_cache.persistence().read();
+        if (!text) return false;
+        m_tail = std::make_unique<StagedCacheReader>(std::move(*text));
+        return true;
+    }
+
+    // The whole file at once, through the cache's own codec.
+    bool loadAll() {
+        m_dehydrated = false;
+        m_tail.reset();
+        m_erased.clear();
+        return m_cache.load();
+    }
+
+    bool loading() const {
+        return m_tail != nullptr;
+    }
+
+    // Parses up to `limit` more entries; `onLoaded` gets the key of each one
+    // added. An entry stored since open() is newer than the file's and
+    // wins, but keeps the file's hits.
+    TailState readTail(size_t limit, std::function<void(uint32_t key)> const& onLoaded = {}) {
+        if (!m_tail) return TailState::Done;
+        m_tail->read(limit, [&](uint32_t key, VerifierData data) {
+            if (m_erased.contains(key)) return;
+            if (auto stored = m_cache.findAnyAge(key)) {
+                stored->hits += data.hits;
+                stored->seen = std::max(stored->seen, data.seen);
+                m_dirty = true;
+                return;
+            }
+            m_cache.store(key, std::move(data));
+            if (onLoaded) onLoaded(key);
+        });
+        if (!m_tail->done()) return TailState::Loading;
+
+        auto state = m_tail->failed() ? TailState::Malformed : TailState::Done;
+        // The next save leaves out whatever was past the damage.
+        if (state == TailState::Malformed) m_dirty = true;
+        m_tail.reset();
+        m_erased.clear();
+        return state;
+    }
+
+    TailState finishLoading(std::function<void(uint32_t key)> const& onLoaded = {}) {
+        return readTail(std::numeric_limits<size_t>::max(), onLoaded);
+    }
+
+    // Carries the access count over from the entry it replaces. Returns how
+    // many entries were evicted to make room.
+    size_t store(uint32_t key, VerifierData data) {
+        if (auto old = m_cache.findAnyAge(key)) {
+            data.hits = old->hits;
+            data.seen = old->seen;
+        }
+        m_dirty = true;
+        return m_cache.store(key, std::move(data));
+    }
+
+    void recordAccess(uint32_t key, long long now) {
+        auto data = m_cache.findAnyAge(key);
+        if (!data) return;
+        ++data->hits;
+        data->seen = now;
+        m_dirty = true;
+    }
+
+    // From memory and from the unread tail.
+    void erase(uint32_t key) {
+        if (m_cache.erase(key)) m_dirty = true;
+        if (!m_tail) return;
+        m_erased.insert(key);
+        m_dirty = true;
+    }
+
+    // Memory and file differ.
+    bool dirty() const {
+        return m_dirty;
+    }
+
+    bool save(long long now) {
+        auto start = std::chrono::steady_clock::now();
+        auto rank = [now](uint32_t, VerifierData const& data) { return cacheFileRank(data, now); };
+        bool ok = m_cache.save(rank, [&](auto& out, bool first) {
+            if (!m_tail) return;
+            m_tail->forEachUnread([&](uint32_t key, std::string_view record) {
+                if (m_erased.contains(key) || m_cache.findAnyAge(key)) return;
+                writeJsonCacheRecord(out, key, record, first);
+                first = false;
+            });
+        });
+        m_lastSave = std::chrono::steady_clock::now() - start;
+        if (ok) m_dirty = false;
+        return ok;
+    }
+
+    // How long the last save() took; zero before the first.
+    std::chrono::steady_clock::duration lastSaveDuration() const {
+        return m_lastSave;
+    }
+
+    // Saves if dirty and drops memory. Does nothing while loading, when
+    // memory is only part of the file and lookups are waiting on the rest,
+    // or if the last save took longer than is left until `deadline`.
+    bool dehydrate(long long now, std::chrono::steady_clock::time_point deadline) {
+        if (m_dehydrated) return true;
+        if (m_tail) return false;
+        if (m_dirty) {
+            if (std::chrono::steady_clock::now() + m_lastSave > deadline) return false;
+            if (!save(now)) return false;
+        }
+        m_cache.clear();
+        m_dehydrated = true;
+        return true;
+    }
+
+    bool dehydrated() const {
+        return m_dehydrated;
+    }
+
+private:
+    Cache m_cache;
+    std::unique_ptr<StagedCacheReader> m_tail;
+    // Erased while loading, so the tail mustn't bring them back.
+    std::unordered_set<uint32_t> m_erased;
+    std::chrono::steady_clock::duration m_lastSave{};
+    bool m_dirty = false;
+    bool m_dehydrated = false;
+};
@@ -0,0 +1,89 @@
+#include "Thumbnail.hpp"
+
+#include <algorithm>
+#include <array>
+
+static constexpr size_t VIDEO_ID_LENGTH = 11;
+
+static bool isVideoIDChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+}
+
+// The ID must be exactly VIDEO_ID_LENGTH characters, ended by the string or
+// a separator.
+static std::optional<std::string> takeVideoID(std::string_view rest) {
+    if (rest.size() < VIDEO_ID_LENGTH) return std::nullopt;
+    auto id = rest.substr(0, VIDEO_ID_LENGTH);
+    if (!std::ranges::all_of(id, isVideoIDChar)) return std::nullopt;
+    if (rest.size() > VIDEO_ID_LENGTH && isVideoIDChar(rest[VIDEO_ID_LENGTH])) return std::nullopt;
+    return std::string(id);
+}
+
+std::optional<std::string> youtubeVideoID(std::string_view url) {
+    for (auto scheme : {"https://", "http://"}) {
+        if (url.starts_with(scheme)) url.remove_prefix(std::string_view(scheme).size());
+    }
+    for (auto prefix : {"www.", "m.", "music."}) {
+        if (url.starts_with(prefix)) url.remove_prefix(std::string_view(prefix).size());
+    }
+
+    if (url.starts_with("youtu.be/")) return takeVideoID(url.substr(9));
+    if (!url.starts_with("youtube.com/")) return std::nullopt;
+    url.remove_prefix(12);
+
+    for (auto path : {"shorts/", "embed/", "live/", "v/"}) {
+        if (url.starts_with(path)) return takeVideoID(url.substr(std::string_view(path).size()));
+    }
+    if (!url.starts_with("watch")) return std::nullopt;
+    auto query = url.find('?');
+    while (query != std::string_view::npos) {
+        auto param = url.substr(query + 1);
+        if (param.starts_with("v=")) return takeVideoID(param.substr(2));
+        query = url.find('&', query + 1);
+    }
+    return std::nullopt;
+}
+
+std::string youtubeThumbnailUrl(std::string_view videoID) {
+    std::string url = "https://i.ytimg.com/vi/";
+    url += videoID;
+    url += "/mqdefault.jpg";
+    return url;
+}
+
+RgbaImage downscaleToRgba(uint8_t const* pixels, int width, int height, int channels, int maxWidth) {
+    RgbaImage out;
+    if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4 || maxWidth <= 0) return out;
+
+    out.width = std::min(width, maxWidth);
+    out.height = std::max(1, static_cast<int>(static_cast<long long>(height) * out.width / width));
+    out.pixels.resize(static_cast<size_t>(out.width) * out.height * 4);
+
+    auto expand = [&](uint8_t const* p, std::array<uint32_t, 4>& sum) {
+        switch (channels) {
+            case 1: sum[0] += p[0]; sum[1] += p[0]; sum[2] += p[0]; sum[3] += 255; break;
+            case 2: sum[0] += p[0]; sum[1] += p[0]; sum[2] += p[0]; sum[3] += p[1]; break;
+            case 3: sum[0] += p[0]; sum[1] += p[1]; sum[2] += p[2]; sum[3] += 255; break;
+            default: sum[0] += p[0]; sum[1] += p[1]; sum[2] += p[2]; sum[3] += p[3]; break;
+        }
+    };
+
+    auto* dst = out.pixels.data();
+    for (int y = 0; y < out.height; ++y) {
+        int y0 = static_cast<int>(static_cast<long long>(y) * height / out.height);
+        int y1 = std::max(y0 + 1, static_cast<int>(static_cast<long long>(y + 1) * height / out.height));
+        for (int x = 0; x < out.width; ++x) {
+            int x0 = static_cast<int>(static_cast<long long>(x) * width / out.width);
+            int x1 = std::max(x0 + 1, static_cast<int>(static_cast<long long>(x + 1) * width / out.width));
+
+            std::array<uint32_t, 4> sum{};
+            for (int sy = y0; sy < y1; ++sy) {
+                auto const* row = pixels + (static_cast<size_t>(sy) * width + x0) * channels;
+                for (int sx = x0; sx < x1; ++sx, row += channels) expand(row, sum);
+            }
+            auto count = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+            for (auto s : sum) *dst++ = static_cast<uint8_t>((s + count / 2) / count);
+        }
+    }
+    return out;
+}
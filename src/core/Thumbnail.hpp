@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The 11-character video ID of a YouTube link (youtu.be/ID, watch?v=ID,
+// /shorts/ID, /embed/ID, /live/ID), or nullopt if `url` isn't one.
+std::optional<std::string> youtubeVideoID(std::string_view url);
+
+// 320x180 without letterboxing; the smallest size that still reads as a frame.
+std::string youtubeThumbnailUrl(std::string_view videoID);
+
+struct RgbaImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels; // width * height * 4, rows top to bottom
+};
+
+// Box-filters 8-bit `channels` (1 to 4) pixels down to at most `maxWidth`
+// wide, keeping the aspect ratio, and always returns RGBA. Images already
+// narrow enough are only converted.
+RgbaImage downscaleToRgba(uint8_t const* pixels, int width, int height, int channels, int maxWidth);
@@ -0,0 +1,412 @@
+#pragma once
+
+#include "FileSink.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Keyed cache with expiry, eviction and persistence chosen at compile time:
+//
+//   TtlCache<Key, Value, Codec, Eviction, Expiry, Persistence>
+//
+// Policies are plain members called directly, and a policy reporting
+// `enabled = false` is compiled out entirely, so a cache without eviction or
+// persistence costs exactly an unordered_map lookup plus the expiry check.
+//
+// Expiry:      bool isFresh(Value const&, long long now) const
+// Eviction:    enabled; onInsert/onAccess/onErase(Key); overCapacity(size);
+//              optional<Key> victim(Map const&); optionally excess(size)
+//              and vector<Key> victims(Map const&, count), to evict many at
+//              once when the capacity shrinks
+// Persistence: enabled; bool write(fn(out)); optional<std::string> read()
+// Codec:       writeBegin/writeEntry/writeEnd(out, ...); bool read(text, fn)
+//              (only used when Persistence is enabled)
+namespace ttl {
+    enum class Lookup { Hit, Miss, Stale };
+
+    template <class V>
+    concept Timestamped = requires(V const& v) {
+        { v.timestamp } -> std::convertible_to<long long>;
+    };
+
+    // --- Expiry ---
+
+    template <long long Seconds>
+    struct FixedTtl {
+        template <Timestamped V>
+        bool isFresh(V const& value, long long now) const {
+            return now - value.timestamp <= Seconds;
+        }
+    };
+
+    struct NeverExpire {
+        template <class V>
+        bool isFresh(V const&, long long) const {
+            return true;
+        }
+    };
+
+    // --- Eviction ---
+
+    template <class Key>
+    struct NoEviction {
+        static constexpr bool enabled = false;
+    };
+
+    // Drops the entry with the oldest timestamp. Keeps no state, so it costs
+    // nothing until the cache is over capacity, and then a scan per eviction,
+    // or one scan for the lot when the capacity shrank.
+    template <class Key>
+    class OldestEviction {
+    public:
+        static constexpr bool enabled = true;
+
+        explicit OldestEviction(size_t capacity = std::numeric_limits<size_t>::max()) : m_capacity(capacity) {}
+
+        void setCapacity(size_t capacity) {
+            m_capacity = capacity;
+        }
+
+        void onInsert(Key const&) {}
+        void onAccess(Key const&) {}
+        void onErase(Key const&) {}
+
+        bool overCapacity(size_t size) const {
+            return size > m_capacity;
+        }
+
+        size_t excess(size_t size) const {
+            return size > m_capacity ? size - m_capacity : 0;
+        }
+
+        template <class Map>
+        std::optional<Key> victim(Map const& map) const {
+            auto oldest = map.end();
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                if (oldest == map.end() || it->second.timestamp < oldest->second.timestamp) oldest = it;
+            }
+            if (oldest == map.end()) return std::nullopt;
+            return oldest->first;
+        }
+
+        // The `count` oldest keys, partitioned out by timestamp in one pass.
+        template <class Map>
+        std::vector<Key> victims(Map const& map, size_t count) const {
+            std::vector<std::pair<long long, Key>> byAge;
+            byAge.reserve(map.size());
+            for (auto const& [key, value] : map) byAge.emplace_back(value.timestamp, key);
+            count = std::min(count, byAge.size());
+            auto older = [](auto const& a, auto const& b) { return a.first < b.first; };
+            std::ranges::nth_element(byAge, byAge.begin() + static_cast<std::ptrdiff_t>(count), older);
+            std::vector<Key> keys;
+            keys.reserve(count);
+            for (size_t i = 0; i < count; ++i) keys.push_back(byAge[i].second);
+            return keys;
+        }
+
+    private:
+        size_t m_capacity;
+    };
+
+    // Least recently used first, O(1) per operation at the cost of a list
+    // node and an index entry per key.
+    template <class Key, class Hash = std::hash<Key>>
+    class LruEviction {
+    public:
+        static constexpr bool enabled = true;
+
+        explicit LruEviction(size_t capacity = std::numeric_limits<size_t>::max()) : m_capacity(capacity) {}
+
+        void setCapacity(size_t capacity) {
+            m_capacity = capacity;
+        }
+
+        void onInsert(Key const& key) {
+            m_order.push_front(key);
+            m_positions[key] = m_order.begin();
+        }
+
+        void onAccess(Key const& key) {
+            auto it = m_positions.find(key);
+            if (it != m_positions.end()) m_order.splice(m_order.begin(), m_order, it->second);
+        }
+
+        void onErase(Key const& key) {
+            auto it = m_positions.find(key);
+            if (it == m_positions.end()) return;
+            m_order.erase(it->second);
+            m_positions.erase(it);
+        }
+
+        bool overCapacity(size_t size) const {
+            return size > m_capacity;
+        }
+
+        template <class Map>
+        std::optional<Key> victim(Map const&) const {
+            if (m_order.empty()) return std::nullopt;
+            return m_order.back();
+        }
+
+    private:
+        size_t m_capacity;
+        std::list<Key> m_order;
+        std::unordered_map<Key, typename std::list<Key>::iterator, Hash> m_positions;
+    };
+
+    // --- Persistence ---
+
+    struct NoPersistence {
+        static constexpr bool enabled = false;
+    };
+
+    // One file, replaced atomically on every save (see FileSink).
+    class FilePersistence {
+    public:
+        static constexpr bool enabled = true;
+
+        FilePersistence() = default;
+        explicit FilePersistence(std::filesystem::path path) : m_path(std::move(path)) {}
+
+        void setPath(std::filesystem::path path) {
+            m_path = std::move(path);
+        }
+        std::filesystem::path const& path() const {
+            return m_path;
+        }
+
+        template <class F>
+        bool write(F&& writeAll) const {
+            FileSink sink(m_path);
+            writeAll(sink);
+            return sink.commit();
+        }
+
+        std::optional<std::string> read() const {
+            std::ifstream in(m_path, std::ios::binary | std::ios::ate);
+            if (!in) return std::nullopt;
+            // Sized up front; going through istreambuf_iterator costs more
+            // than parsing the hot head does.
+            auto size = in.tellg();
+            if (size < 0) return std::nullopt;
+            std::string text(static_cast<size_t>(size), '\0');
+            in.seekg(0);
+            if (!in.read(text.data(), size)) return std::nullopt;
+            return text;
+        }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    // Keeps the encoded cache in memory; for tests and benchmarks.
+    class StringPersistence {
+    public:
+        static constexpr bool enabled = true;
+
+        template <class F>
+        bool write(F&& writeAll) {
+            m_data.clear();
+            writeAll(m_data);
+            return true;
+        }
+
+        std::optional<std::string> read() const {
+            return m_data;
+        }
+
+        std::string const& data() const {
+            return m_data;
+        }
+
+    private:
+        std::string m_data;
+    };
+
+    // For caches that are never persisted.
+    struct NoCodec {};
+
+    template <
+        class Key, class Value, class Codec, class Eviction, class Expiry, class Persistence,
+        class Hash = std::hash<Key>
+    >
+    class TtlCache {
+    public:
+        using Map = std::unordered_map<Key, Value, Hash>;
+
+        struct Result {
+            Value const* value;
+            Lookup status;
+        };
+
+        explicit TtlCache(Eviction eviction = Eviction(), Expiry expiry = Expiry(), Persistence persistence = Persistence())
+            : m_eviction(std::move(eviction)), m_expiry(std::move(expiry)), m_persistence(std::move(persistence)) {}
+
+        Result lookup(Key const& key, long long now) {
+            auto it = m_map.find(key);
+            if (it == m_map.end()) return {nullptr, Lookup::Miss};
+            if (!m_expiry.isFresh(it->second, now)) return {nullptr, Lookup::Stale};
+            if constexpr (Eviction::enabled) m_eviction.onAccess(key);
+            return {&it->second, Lookup::Hit};
+        }
+
+        Value const* find(Key const& key, long long now) {
+            return lookup(key, now).value;
+        }
+
+        // Ignores expiry and doesn't count as an access.
+        Value const* findAnyAge(Key const& key) const {
+            auto it = m_map.find(key);
+            return it == m_map.end() ? nullptr : &it->second;
+        }
+        Value* findAnyAge(Key const& key) {
+            auto it = m_map.find(key);
+            return it == m_map.end() ? nullptr : &it->second;
+        }
+
+        // Returns how many entries were evicted to make room.
+        size_t store(Key const& key, Value value) {
+            auto [it, inserted] = m_map.insert_or_assign(key, std::move(value));
+            if constexpr (Eviction::enabled) {
+                if (inserted) m_eviction.onInsert(key);
+                else m_eviction.onAccess(key);
+            }
+            return trim();
+        }
+
+        // Evicts down to capacity; needed only after the capacity shrank, as
+        // store() does it too. Returns how many entries were evicted.
+        size_t trim() {
+            size_t evicted = 0;
+            if constexpr (Eviction::enabled) {
+                if constexpr (requires { m_eviction.victims(m_map, size_t{}); }) {
+                    if (auto excess = m_eviction.excess(m_map.size()); excess > 1) {
+                        for (auto const& victim : m_eviction.victims(m_map, excess)) evicted += erase(victim);
+                    }
+                }
+                while (m_eviction.overCapacity(m_map.size())) {
+                    auto victim = m_eviction.victim(m_map);
+                    if (!victim || !erase(*victim)) break;
+                    ++evicted;
+                }
+            }
+            return evicted;
+        }
+
+        bool erase(Key const& key) {
+            if (!m_map.erase(key)) return false;
+            if constexpr (Eviction::enabled) m_eviction.onErase(key);
+            return true;
+        }
+
+        // Drops entries past expiry. Returns how many.
+        size_t eraseExpired(long long now) {
+            size_t erased = 0;
+            for (auto it = m_map.begin(); it != m_map.end();) {
+                if (m_expiry.isFresh(it->second, now)) {
+                    ++it;
+                    continue;
+                }
+                if constexpr (Eviction::enabled) m_eviction.onErase(it->first);
+                it = m_map.erase(it);
+                ++erased;
+            }
+            return erased;
+        }
+
+        // Drops everything and hands the table's memory back.
+        void clear() {
+            if constexpr (Eviction::enabled) {
+                for (auto const& [key, value] : m_map) m_eviction.onErase(key);
+            }
+            Map().swap(m_map);
+        }
+
+        size_t size() const {
+            return m_map.size();
+        }
+
+        template <class F>
+        void forEach(F&& fn) const {
+            for (auto const& [key, value] : m_map) fn(key, value);
+        }
+
+        Eviction& eviction() {
+            return m_eviction;
+        }
+        Expiry& expiry() {
+            return m_expiry;
+        }
+        Persistence& persistence() {
+            return m_persistence;
+        }
+
+        bool save() requires(Persistence::enabled) {
+            return m_persistence.write([&](auto& out) {
+                Codec::writeBegin(out);
+                bool first = true;
+                for (auto const& [key, value] : m_map) {
+                    Codec::writeEntry(out, key, value, first);
+                    first = false;
+                }
+                Codec::writeEnd(out);
+            });
+        }
+
+        // Writes entries in ascending `rank(key, value)` order, for stores
+        // that are read back a piece at a time. `writeRest(out, first)` may
+        // add entries the cache doesn't hold after them, through the codec's
+        // own writers; `first` says whether nothing was written yet.
+        template <class Rank>
+        bool save(Rank&& rank) requires(Persistence::enabled) {
+            return save(std::forward<Rank>(rank), [](auto&, bool) {});
+        }
+
+        template <class Rank, class Rest>
+        bool save(Rank&& rank, Rest&& writeRest) requires(Persistence::enabled) {
+            using RankOf = std::invoke_result_t<Rank&, Key const&, Value const&>;
+            std::vector<std::pair<RankOf, typename Map::value_type const*>> order;
+            order.reserve(m_map.size());
+            for (auto const& entry : m_map) order.emplace_back(rank(entry.first, entry.second), &entry);
+            std::ranges::sort(order, [](auto const& a, auto const& b) { return a.first < b.first; });
+            return m_persistence.write([&](auto& out) {
+                Codec::writeBegin(out);
+                bool first = true;
+                for (auto const& ranked : order) {
+                    Codec::writeEntry(out, ranked.second->first, ranked.second->second, first);
+                    first = false;
+                }
+                writeRest(out, first);
+                Codec::writeEnd(out);
+            });
+        }
+
+        // Adds what the store holds on top of the current entries. False if
+        // there was nothing to read or it was malformed; entries read before
+        // the problem are kept.
+        bool load() requires(Persistence::enabled) {
+            auto text = m_persistence.read();
+            if (!text) return false;
+            return Codec::read(*text, [&](Key const& key, Value value) { store(key, std::move(value)); });
+        }
+
+    private:
+        Map m_map;
+        [[no_unique_address]] Eviction m_eviction;
+        [[no_unique_address]] Expiry m_expiry;
+        [[no_unique_address]] Persistence m_persistence;
+    };
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Schema.hpp"
+
+#include <string>
+
+struct VerifierData {
+    std::string verifier;
+    std::string video;
+    bool legacy = false;
+    long long timestamp = 0;
+    // Interactive lookups and when the last one was; the cache file is
+    // written hottest first (see CacheFile.hpp).
+    int hits = 0;
+    long long seen = 0;
+    // Which list the level is on, so it can be fetched again from the right
+    // API. Last, so older binary files still decode.
+    bool platformer = false;
+};
+
+template <>
+struct Schema<VerifierData> {
+    static constexpr std::tuple fields{
+        field("verifier", &VerifierData::verifier),
+        field("video", &VerifierData::video),
+        field("legacy", &VerifierData::legacy),
+        field("timestamp", &VerifierData::timestamp),
+        field("hits", &VerifierData::hits),
+        field("seen", &VerifierData::seen),
+        field("platformer", &VerifierData::platformer),
+    };
+};
@@ -0,0 +1,23 @@
+#include "VerifierLabel.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Longest prefix of `text` up to `max` bytes that ends on a code point.
+static size_t utf8Prefix(std::string_view text, size_t max) {
+    if (text.size() <= max) return text.size();
+    // Back off continuation bytes (10xxxxxx) to the start of their sequence.
+    while (max > 0 && (static_cast<unsigned char>(text[max]) & 0xc0) == 0x80) --max;
+    return max;
+}
+
+char const* formatVerifierLabel(VerifierLabel& out, std::string_view verifier, bool duo, bool twoPlayer) {
+    std::string_view prefix = duo ? "[2P] " : twoPlayer ? "[Solo] Verified by: " : "Verified by: ";
+    auto room = out.size() - 1;
+    std::memcpy(out.data(), prefix.data(), prefix.size());
+    room -= prefix.size();
+    auto length = utf8Prefix(verifier, room);
+    std::memcpy(out.data() + prefix.size(), verifier.data(), length);
+    out[prefix.size() + length] = '\0';
+    return out.data();
+}
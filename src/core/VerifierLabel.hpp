@@ -0,0 +1,16 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+// The level page's "Verified by: ..." text, built on every cache hit. It goes
+// into a fixed buffer so showing it doesn't allocate; a name too long for it
+// is cut between code points, never inside one.
+static constexpr size_t VERIFIER_LABEL_MAX = 128;
+
+using VerifierLabel = std::array<char, VERIFIER_LABEL_MAX>;
+
+// `duo` is the 2P entry of a level; `twoPlayer` says the level has a 2P mode,
+// so a solo entry needs saying so. Returns out.data(), null-terminated.
+char const* formatVerifierLabel(VerifierLabel& out, std::string_view verifier, bool duo, bool twoPlayer);
@@ -0,0 +1,60 @@
+#include "WorkQueue.hpp"
+
+#include <algorithm>
+
+WorkQueue::WorkQueue(size_t threads, size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+        m_workers.emplace_back([this] { work(); });
+    }
+}
+
+WorkQueue::~WorkQueue() {
+    {
+        std::lock_guard lock(m_lock);
+        m_stopping = true;
+    }
+    m_signal.notify_all();
+    for (auto& worker : m_workers) worker.join();
+}
+
+void WorkQueue::push(Job job, std::function<void()> dropped) {
+    ++m_inFlight;
+    {
+        std::lock_guard lock(m_lock);
+        if (m_waiting.size() == m_capacity) {
+            m_finished.push_back(std::move(m_waiting.front().dropped));
+            m_waiting.pop_front();
+        }
+        m_waiting.push_back({std::move(job), std::move(dropped)});
+    }
+    m_signal.notify_one();
+}
+
+size_t WorkQueue::poll() {
+    std::vector<std::function<void()>> finished;
+    {
+        std::lock_guard lock(m_lock);
+        finished.swap(m_finished);
+    }
+    for (auto& done : finished) {
+        --m_inFlight;
+        if (done) done();
+    }
+    return finished.size();
+}
+
+void WorkQueue::work() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(m_lock);
+            m_signal.wait(lock, [this] { return m_stopping || !m_waiting.empty(); });
+            if (m_stopping) return;
+            job = std::move(m_waiting.front().job);
+            m_waiting.pop_front();
+        }
+        auto done = job();
+        std::lock_guard lock(m_lock);
+        m_finished.push_back(std::move(done));
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads taking CPU-bound jobs off a bounded queue.
+// As with AsyncIo, results come back through poll() on the owning thread, so
+// workers never call into the game themselves. Not thread-safe itself: one
+// thread pushes and polls.
+class WorkQueue {
+public:
+    // Runs on a worker. What it returns runs on the owning thread in poll().
+    using Job = std::function<std::function<void()>()>;
+
+    // At most `capacity` jobs wait for a worker; pushing onto a full queue
+    // drops the oldest waiting job, whose `dropped` runs in the next poll().
+    WorkQueue(size_t threads, size_t capacity);
+    // Joins the workers. Waiting jobs are dropped without callbacks.
+    ~WorkQueue();
+
+    WorkQueue(WorkQueue const&) = delete;
+    WorkQueue& operator=(WorkQueue const&) = delete;
+
+    void push(Job job, std::function<void()> dropped);
+    // Runs the results of finished and dropped jobs. Returns how many ran.
+    size_t poll();
+    // Jobs pushed whose result or `dropped` hasn't run yet.
+    size_t inFlight() const {
+        return m_inFlight;
+    }
+
+private:
+    struct Waiting {
+        Job job;
+        std::function<void()> dropped;
+    };
+
+    void work();
+
+    std::mutex m_lock;
+    std::condition_variable m_signal;
+    std::deque<Waiting> m_waiting;
+    std::vector<std::function<void()>> m_finished;
+    std::vector<std::thread> m_workers;
+    size_t m_capacity;
+    size_t m_inFlight = 0;
+    bool m_stopping = false;
+};
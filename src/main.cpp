@@ -1,88 +1,44 @@
 #include <Geode/Geode.hpp>
 #include <Geode/modify/LevelInfoLayer.hpp>
 #include <Geode/utils/web.hpp>
-#include <Geode/utils/file.hpp>
-#include <matjson.hpp>
-#include <matjson/std.hpp>
 
-#include <algorithm>
-#include <chrono>
-#include <unordered_map>
+#include "AuditLog.hpp"
+#include "Changelog.hpp"
+#include "LevelEvents.hpp"
+#include "LevelRequests.hpp"
+#include "LevelSets.hpp"
+#include "Lifecycle.hpp"
+#include "ListSnapshot.hpp"
+#include "RecordsPopup.hpp"
+#include "Metrics.hpp"
+#include "Settings.hpp"
+#include "Sync.hpp"
+#include "Thumbnails.hpp"
+#include "VerifierCache.hpp"
+#include "core/LevelKey.hpp"
+#include "core/VerifierLabel.hpp"
 
 using namespace geode::prelude;
-using namespace matjson;
-
-static constexpr const char* CACHE_FILE = "verifier_cache.json";
-static constexpr const char* CLASSIC_API = "https://api.aredl.net/v2/api/aredl/levels";
-static constexpr const char* PLATFORMER_API = "https://api.aredl.net/v2/api/arepl/levels";
-static constexpr long long CACHE_EXPIRY = 1800;
-
-struct VerifierData {
-    std::string verifier;
-    std::string video;
-    bool legacy = false;
-    long long timestamp = 0;
-};
 
-template<>
-struct matjson::Serialize<VerifierData> {
-    static Result<VerifierData> from_json(Value const& v) {
-        if (!v.isObject()) return Err("expected object");
-        return Ok(VerifierData{
-            v.contains("verifier") ? v["verifier"].asString().unwrapOr("") : "",
-            v.contains("video") ? v["video"].asString().unwrapOr("") : "",
-            v.contains("legacy") ? v["legacy"].asBool().unwrapOr(false) : false,
-            v.contains("timestamp") ? static_cast<long long>(v["timestamp"].asInt().unwrapOr(0)) : 0
-        });
-    }
-    static Value to_json(VerifierData const& d) {
-        return makeObject({
-            {"verifier", d.verifier},
-            {"video", d.video},
-            {"legacy", d.legacy},
-            {"timestamp", d.timestamp}
-        });
-    }
-};
-
-static std::unordered_map<std::string, VerifierData> s_cache;
+static constexpr float PREVIEW_WIDTH = 96.f;
+static constexpr float PREVIEW_HEIGHT = 54.f;
 
-static void saveCache() {
-    if (Mod::get()->getSettingValue<bool>("disable-cache")) return;
-    auto obj = Value::object();
-    for (auto const& [k, d] : s_cache) {
-        obj.set(k, Serialize<VerifierData>::to_json(d));
-    }
-    auto path = Mod::get()->getSaveDir() / CACHE_FILE;
-    if (auto res = file::writeString(path, obj.dump(NO_INDENTATION)); !res) {
-        log::error("Failed to save cache: {}", res.unwrapErr());
-    }
-}
-
-static void loadCache() {
-    if (Mod::get()->getSettingValue<bool>("disable-cache")) return;
-    auto path = Mod::get()->getSaveDir() / CACHE_FILE;
-    std::error_code ec;
-    if (!std::filesystem::exists(path, ec) || ec) return;
-    if (auto res = file::readJson(path)) {
-        auto root = res.unwrap();
-        if (!root.isObject()) return;
-        for (auto const& [k, v] : root) {
-            if (auto parsed = Serialize<VerifierData>::from_json(v)) {
-                s_cache[k] = parsed.unwrap();
-            }
-        }
-    }
-}
-
-static long long nowSec() {
-    return std::chrono::duration_cast<std::chrono::seconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+static std::string formatAge(long long seconds) {
+    if (seconds < 60) return "just now";
+    if (seconds < 3600) return fmt::format("{}m ago", seconds / 60);
+    if (seconds < 86400) return fmt::format("{}h ago", seconds / 3600);
+    return fmt::format("{}d ago", seconds / 86400);
 }
 
 $execute {
+    initSettings();
+    loadAuditLog();
+    loadChangelog();
     loadCache();
+    loadSnapshots();
+    loadLevelSets();
+    initMetrics();
+    initLifecycle();
 }
 
 class $modify(VerifierInfoLayer, LevelInfoLayer) {
@@ -90,10 +46,15 @@ class $modify(VerifierInfoLayer, LevelInfoLayer) {
         CCLabelBMFont* m_label = nullptr;
         CCMenuItemSpriteExtra* m_labelBtn = nullptr;
         CCMenuItemSpriteExtra* m_ytBtn = nullptr;
-        async::TaskHolder<web::WebResponse> m_soloTask;
-        async::TaskHolder<web::WebResponse> m_duoTask;
-        std::string m_videoUrl;
+        CCMenuItemSpriteExtra* m_recordsBtn = nullptr;
+        // Offline mode only.
+        CCLabelBMFont* m_ageLabel = nullptr;
+        CCMenuItemSpriteExtra* m_syncBtn = nullptr;
+        // Video preview only.
+        CCMenuItemSpriteExtra* m_preview = nullptr;
+        uint32_t m_videoKey = 0;
         bool m_duo = false;
+        LevelSubscription m_updates;
     };
 
     bool init(GJGameLevel* level, bool p1);
@@ -108,7 +69,7 @@ class $modify(VerifierInfoLayer, LevelInfoLayer) {
         m_fields->m_label->setScale(0.4f);
         m_fields->m_label->setID("verifier-label"_spr);
 
-        bool left = Mod::get()->getSettingValue<std::string>("label-alignment") == "Left";
+        bool left = settings().leftAligned;
         m_fields->m_label->setAnchorPoint(left ? ccp(0, 0.5f) : ccp(0.5f, 0.5f));
 
         m_fields->m_labelBtn = CCMenuItemSpriteExtra::create(
@@ -130,10 +91,39 @@ class $modify(VerifierInfoLayer, LevelInfoLayer) {
         }
 
         menu->addChild(m_fields->m_labelBtn);
+
+        if (auto listIcon = CCSprite::createWithSpriteFrameName("GJ_infoIcon_001.png")) {
+            listIcon->setScale(0.4f);
+            m_fields->m_recordsBtn = CCMenuItemSpriteExtra::create(
+                listIcon, this, menu_selector(VerifierInfoLayer::onRecords)
+            );
+            m_fields->m_recordsBtn->setID("verifier-records-btn"_spr);
+            m_fields->m_recordsBtn->setVisible(false);
+            menu->addChild(m_fields->m_recordsBtn);
+        }
+
+        if (settings().offlineMode) {
+            m_fields->m_ageLabel = CCLabelBMFont::create("", "chatFont.fnt");
+            m_fields->m_ageLabel->setScale(0.45f);
+            m_fields->m_ageLabel->setColor({200, 200, 200});
+            m_fields->m_ageLabel->setPosition({0, -11.f});
+            m_fields->m_ageLabel->setID("verifier-age-label"_spr);
+            menu->addChild(m_fields->m_ageLabel);
+
+            if (auto syncIcon = CCSprite::createWithSpriteFrameName("GJ_updateBtn_001.png")) {
+                syncIcon->setScale(0.3f);
+                m_fields->m_syncBtn = CCMenuItemSpriteExtra::create(
+                    syncIcon, this, menu_selector(VerifierInfoLayer::onSync)
+                );
+                m_fields->m_syncBtn->setID("verifier-sync-btn"_spr);
+                menu->addChild(m_fields->m_syncBtn);
+            }
+        }
+
         this->addChild(menu);
 
         if (auto anchor = this->getChildByID("creator-info-menu")) {
-            auto yOff = static_cast<float>(Mod::get()->getSettingValue<double>("y-offset"));
+            auto yOff = settings().yOffset;
             menu->setPosition(anchor->getPosition() + ccp(0, yOff));
         }
     }
@@ -153,46 +143,106 @@ class $modify(VerifierInfoLayer, LevelInfoLayer) {
         }
     }
 
-    std::string levelKey() {
-        return std::to_string(m_level->m_levelID) + (m_fields->m_duo ? "_2p" : "");
+    uint32_t levelKey() {
+        return packLevelKey(static_cast<int>(m_level->m_levelID), m_fields->m_duo);
     }
 
     void refreshLabel() {
         if (!m_level) return;
 
-        bool cacheDisabled = Mod::get()->getSettingValue<bool>("disable-cache");
-        if (!cacheDisabled) {
-            auto it = s_cache.find(levelKey());
-            if (it != s_cache.end() && (nowSec() - it->second.timestamp) <= CACHE_EXPIRY) {
-                applyData(it->second);
-                return;
-            }
+        if (settings().offlineMode) {
+            refreshOffline();
+            return;
+        }
+
+        if (auto cached = findCached(levelKey())) {
+            applyData(*cached);
+            return;
         }
 
         m_fields->m_label->setString("Checking...");
         m_fields->m_labelBtn->setVisible(true);
         if (m_fields->m_ytBtn) m_fields->m_ytBtn->setVisible(false);
+        if (m_fields->m_recordsBtn) m_fields->m_recordsBtn->setVisible(false);
     }
 
+    // Offline, any saved entry is shown whatever its age, and the age is shown
+    // next to it instead.
+    void refreshOffline() {
+        bool platformer = m_level->isPlatformer();
+        auto cached = findCachedAnyAge(levelKey());
+        auto syncedAt = snapshotSyncedAt(platformer);
+
+        if (!isSyncing()) {
+            if (cached) setAgeText("Saved " + formatAge(nowSec() - cached->timestamp));
+            else if (syncedAt) setAgeText("Lists synced " + formatAge(nowSec() - *syncedAt));
+            else setAgeText("Never synced");
+        }
+
+        if (cached) {
+            applyData(*cached);
+        }
+        else if (syncedAt && !findInSnapshot(platformer, static_cast<int>(m_level->m_levelID), m_fields->m_duo)) {
+            applyData({});
+        }
+        else {
+            m_fields->m_label->setString("Not synced yet");
+            m_fields->m_labelBtn->setVisible(true);
+            if (m_fields->m_ytBtn) m_fields->m_ytBtn->setVisible(false);
+            if (m_fields->m_recordsBtn) m_fields->m_recordsBtn->setVisible(false);
+        }
+    }
+
+    void setAgeText(std::string const& text) {
+        if (!m_fields->m_ageLabel) return;
+        m_fields->m_ageLabel->setString(text.c_str());
+        if (m_fields->m_syncBtn) {
+            m_fields->m_syncBtn->setPosition({m_fields->m_ageLabel->getScaledContentSize().width / 2 + 8.f, -11.f});
+        }
+    }
+
+    void onSync(CCObject*) {
+        m_fields->m_syncBtn->setEnabled(false);
+        WeakRef<VerifierInfoLayer> self = this;
+        startSync([self](SyncProgress const& progress) {
+            auto layer = self.lock();
+            if (!layer) return;
+
+            if (!progress.finished) {
+                layer->setAgeText(fmt::format("Syncing {}/{}", progress.done, progress.total));
+                return;
+            }
+
+            layer->m_fields->m_syncBtn->setEnabled(true);
+            layer->refreshLabel();
+            Notification::create(
+                progress.ok ? "Verifier data synced" : "Sync incomplete, try again later",
+                progress.ok ? NotificationIcon::Success : NotificationIcon::Warning
+            )->show();
+        });
+    }
+
+    // Runs on every cache hit, so it must not allocate: the label text is
+    // formatted on the stack (see verifier-hitpathcheck) and the video URL is
+    // looked up only on click.
     void applyData(VerifierData const& d) {
+        hidePreview();
         auto hide = [&] {
             m_fields->m_labelBtn->setVisible(false);
             if (m_fields->m_ytBtn) m_fields->m_ytBtn->setVisible(false);
+            if (m_fields->m_recordsBtn) m_fields->m_recordsBtn->setVisible(false);
         };
 
         if (d.verifier.empty()) { hide(); return; }
 
         if (m_level && m_level->m_demonDifficulty == 5 && !d.legacy) { hide(); return; }
 
-        m_fields->m_videoUrl = d.video;
+        m_fields->m_videoKey = levelKey();
 
-        auto prefix = m_fields->m_duo
-            ? "[2P] "
-            : (m_level->m_twoPlayerMode ? "[Solo] Verified by: " : "Verified by: ");
+        VerifierLabel text;
+        m_fields->m_label->setString(formatVerifierLabel(text, d.verifier, m_fields->m_duo, m_level->m_twoPlayerMode));
 
-        m_fields->m_label->setString((prefix + d.verifier).c_str());
-
-        bool grayed = d.legacy && Mod::get()->getSettingValue<bool>("legacy-color");
+        bool grayed = d.legacy && settings().legacyColor;
         m_fields->m_label->setFntFile(grayed ? "bigFont.fnt" : "goldFont.fnt");
 
         float scale = grayed ? 0.35f : 0.4f;
@@ -205,7 +255,7 @@ class $modify(VerifierInfoLayer, LevelInfoLayer) {
         m_fields->m_labelBtn->setEnabled(m_level && m_level->m_twoPlayerMode);
 
         if (m_fields->m_ytBtn) {
-            bool showYt = !d.video.empty() && Mod::get()->getSettingValue<bool>("show-youtube");
+            bool showYt = !d.video.empty() && settings().showYoutube;
             m_fields->m_ytBtn->setVisible(showYt);
             if (showYt) {
                 m_fields->m_ytBtn->setPosition({
@@ -214,90 +264,118 @@ class $modify(VerifierInfoLayer, LevelInfoLayer) {
             }
         }
 
+        // The full list needs the network.
+        if (m_fields->m_recordsBtn) {
+            bool showRecords = !settings().offlineMode;
+            m_fields->m_recordsBtn->setVisible(showRecords);
+            if (showRecords) {
+                m_fields->m_recordsBtn->setPosition({
+                    -(m_fields->m_label->getScaledContentSize().width / 2 + 8.f), 0
+                });
+            }
+        }
+
         m_fields->m_labelBtn->updateSprite();
     }
 
-    void onVideo(CCObject*) {
-        if (!m_fields->m_videoUrl.empty()) {
-            web::openLinkInBrowser(m_fields->m_videoUrl);
-        }
+    void onRecords(CCObject*) {
+        auto d = findCachedAnyAge(levelKey());
+        if (!d || d->verifier.empty()) return;
+        if (auto popup = RecordsPopup::create(m_level->isPlatformer(), levelKey(), d->verifier)) popup->show();
     }
 
-    void fetchLevel(std::string key, bool duo) {
-        auto url = std::string(m_level->isPlatformer() ? PLATFORMER_API : CLASSIC_API) + "/" + key;
-        auto& holder = duo ? m_fields->m_duoTask : m_fields->m_soloTask;
+    void onVideo(CCObject* sender) {
+        if (!settings().videoPreview) {
+            onOpenVideo(sender);
+            return;
+        }
+        if (m_fields->m_preview) hidePreview();
+        else showPreview();
+    }
 
-        holder.spawn(web::WebRequest().userAgent("Geode-AREDL-Mod/1.0.1").get(url), [this, key](web::WebResponse res) {
-            if (!res.ok()) {
-                log::debug("API request failed for {}: {}", key, res.code());
-                s_cache[key] = {"", "", false, nowSec()};
-                saveCache();
-                if (key == levelKey()) refreshLabel();
-                return;
-            }
+    void onOpenVideo(CCObject*) {
+        auto d = findCachedAnyAge(m_fields->m_videoKey);
+        if (d && !d->video.empty()) {
+            web::openLinkInBrowser(d->video);
+        }
+    }
 
-            auto parsed = res.json();
-            if (!parsed.isOk()) {
-                log::debug("Failed to parse JSON response for {}", key);
-                s_cache[key] = {"", "", false, nowSec()};
-                saveCache();
-                if (key == levelKey()) refreshLabel();
+    // Shown above the YouTube button; tapping it opens the video. The frame
+    // goes up right away and the thumbnail fills it in once loaded.
+    void showPreview() {
+        auto d = findCachedAnyAge(m_fields->m_videoKey);
+        if (!d || d->video.empty() || !m_fields->m_ytBtn) return;
+
+        auto frame = CCScale9Sprite::create("square02_small.png");
+        frame->setContentSize({PREVIEW_WIDTH + 6.f, PREVIEW_HEIGHT + 6.f});
+        frame->setOpacity(160);
+
+        auto status = CCLabelBMFont::create("Loading...", "chatFont.fnt");
+        status->setScale(0.5f);
+        status->setPosition(frame->getContentSize() / 2);
+        status->setID("verifier-preview-status"_spr);
+        frame->addChild(status);
+
+        auto preview = CCMenuItemSpriteExtra::create(frame, this, menu_selector(VerifierInfoLayer::onOpenVideo));
+        preview->setID("verifier-preview-btn"_spr);
+        preview->setPosition(m_fields->m_ytBtn->getPosition() + ccp(0, PREVIEW_HEIGHT / 2 + 14.f));
+        m_fields->m_ytBtn->getParent()->addChild(preview);
+        m_fields->m_preview = preview;
+
+        WeakRef<CCMenuItemSpriteExtra> weak = preview;
+        requestThumbnail(d->video, [weak, frame, status](CCTexture2D* texture) {
+            // Gone if the preview was hidden before the thumbnail arrived.
+            auto item = weak.lock();
+            if (!item || !item->getParent()) return;
+
+            if (!texture) {
+                status->setString("No preview");
                 return;
             }
-            auto root = parsed.unwrap();
-
-            std::vector<std::string> names;
-            std::string video;
-            bool legacy = root.contains("legacy") && root["legacy"].asBool().unwrapOr(false);
-
-            if (root.contains("verifications")) {
-                auto arr = root["verifications"];
-                if (arr.isArray()) {
-                    for (auto const& v : arr) {
-                        if (!v.isObject()) continue;
-                        if (video.empty() && v.contains("video_url")) {
-                            video = v["video_url"].asString().unwrapOr("");
-                        }
-                        if (v.contains("submitted_by")) {
-                            auto sub = v["submitted_by"];
-                            if (!sub.isObject()) continue;
-                            std::string name = sub.contains("global_name")
-                                ? sub["global_name"].asString().unwrapOr("") : "";
-                            if (name.empty()) name = sub.contains("username")
-                                ? sub["username"].asString().unwrapOr("") : "";
-                            if (name.empty()) name = "Unknown";
-                            if (std::ranges::find(names, name) == names.end()) {
-                                names.push_back(name);
-                            }
-                        }
-                    }
-                }
-            }
+            status->removeFromParent();
+            auto sprite = CCSprite::createWithTexture(texture);
+            sprite->setScale(PREVIEW_WIDTH / sprite->getContentSize().width);
+            sprite->setPosition(frame->getContentSize() / 2);
+            frame->addChild(sprite);
+        });
+    }
 
-            std::string display;
-            if (names.size() == 1) display = names[0];
-            else if (names.size() >= 2) display = names[0] + " & " + names[1];
+    void hidePreview() {
+        if (!m_fields->m_preview) return;
+        m_fields->m_preview->removeFromParent();
+        m_fields->m_preview = nullptr;
+    }
 
-            s_cache[key] = {display, video, legacy, nowSec()};
-            saveCache();
-            if (key == levelKey()) refreshLabel();
-        });
+    // Results come back through the subscription made in init().
+    void requestData(bool duo) {
+        resolveLevel(m_level->isPlatformer(), static_cast<int>(m_level->m_levelID), duo, nullptr);
     }
 };
 
 bool VerifierInfoLayer::init(GJGameLevel* level, bool p1) {
     if (!LevelInfoLayer::init(level, p1)) return false;
-    if (!Mod::get()->getSettingValue<bool>("show-label")) return true;
+    if (!settings().showLabel) return true;
     if (!m_level) return true;
 
     buildUI();
 
     if (m_level->m_levelID > 0 && m_level->m_demonDifficulty >= 5) {
+        // The subscription lives in m_fields, so it can't outlive the layer.
+        int id = static_cast<int>(m_level->m_levelID);
+        m_fields->m_updates = subscribeLevels({packLevelKey(id, false), packLevelKey(id, true)}, [this](uint32_t key) {
+            if (key == levelKey()) refreshLabel();
+        });
+
+        // Polling first, so a poll that's due is on its way before the label
+        // decides whether the entry it has is still good.
+        if (!settings().offlineMode) pollChangelogIfDue();
         refreshLabel();
-        auto id = std::to_string(m_level->m_levelID);
-        fetchLevel(id, false);
+        if (settings().offlineMode) return true;
+
+        syncSnapshotIfStale(m_level->isPlatformer());
+        requestData(false);
         if (m_level->m_twoPlayerMode) {
-            fetchLevel(id + "_2p", true);
+            requestData(true);
         }
     }
 
@@ -0,0 +1,127 @@
+// Summarizes an audit.bin written by the mod's request audit log.
+//
+//   verifier-auditdump [--records] audit.bin
+
+#include "core/AuditLog.hpp"
+#include "core/LevelKey.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Matches CACHE_EXPIRY in the mod: a successful fetch should have been served
+// from the cache for at least this long.
+static constexpr uint32_t REDUNDANT_WINDOW = 1800;
+
+static std::string formatAge(uint32_t age) {
+    if (age == AUDIT_NO_ENTRY) return "-";
+    return std::to_string(age) + "s";
+}
+
+static void printRecord(AuditRecord const& r) {
+    std::printf(
+        "%u %-10s %-14s %-8s %-12s age=%-8s %s\n",
+        r.time, formatLevelKey(r.key).c_str(), auditDecisionName(r.decision), auditReasonName(r.reason),
+        auditOutcomeName(r.outcome), formatAge(r.entryAge).c_str(), r.background ? "background" : "interactive"
+    );
+}
+
+template <class Map, class Name>
+static void printCounts(char const* title, Map const& counts, Name name) {
+    std::printf("\n%s\n", title);
+    for (auto const& [value, count] : counts) std::printf("  %-28s %zu\n", name(value).c_str(), count);
+}
+
+static void summarize(AuditRing const& ring) {
+    std::map<AuditDecision, size_t> decisions;
+    std::map<std::pair<AuditReason, bool>, size_t> queued;
+    std::map<AuditOutcome, size_t> outcomes;
+    std::unordered_map<uint32_t, size_t> dispatches;
+    std::unordered_map<uint32_t, uint32_t> lastSuccess;
+    size_t redundant = 0;
+    uint32_t first = 0, last = 0;
+
+    ring.forEach([&](AuditRecord const& r) {
+        if (!first) first = r.time;
+        last = r.time;
+        ++decisions[r.decision];
+        switch (r.decision) {
+            case AuditDecision::Queued:
+                ++queued[{r.reason, r.background != 0}];
+                break;
+            case AuditDecision::Dispatched: {
+                ++dispatches[r.key];
+                auto it = lastSuccess.find(r.key);
+                if (it != lastSuccess.end() && r.time - it->second < REDUNDANT_WINDOW) ++redundant;
+                break;
+            }
+            case AuditDecision::Completed:
+                ++outcomes[r.outcome];
+                if (r.outcome == AuditOutcome::Ok || r.outcome == AuditOutcome::NotFound) lastSuccess[r.key] = r.time;
+                break;
+            default:
+                break;
+        }
+    });
+
+    std::printf("%zu records over %u seconds\n", ring.size(), last - first);
+
+    printCounts("Decisions", decisions, [](AuditDecision d) { return std::string(auditDecisionName(d)); });
+    printCounts("Requests queued by reason", queued, [](auto const& k) {
+        return std::string(auditReasonName(k.first)) + (k.second ? " (background)" : " (interactive)");
+    });
+    printCounts("Responses by outcome", outcomes, [](AuditOutcome o) { return std::string(auditOutcomeName(o)); });
+
+    size_t sent = 0;
+    for (auto const& [key, count] : dispatches) sent += count;
+    std::printf(
+        "\n%zu requests sent for %zu keys; %zu within %us of an earlier successful fetch\n",
+        sent, dispatches.size(), redundant, REDUNDANT_WINDOW
+    );
+
+    std::vector<std::pair<uint32_t, size_t>> top(dispatches.begin(), dispatches.end());
+    std::ranges::sort(top, [](auto const& a, auto const& b) { return a.second > b.second; });
+    if (top.size() > 10) top.resize(10);
+    if (!top.empty() && top.front().second > 1) {
+        std::printf("\nMost requested keys\n");
+        for (auto const& [key, count] : top) {
+            if (count > 1) std::printf("  %-28s %zu\n", formatLevelKey(key).c_str(), count);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    bool records = false;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--records") == 0) records = true;
+        else path = argv[i];
+    }
+    if (!path) {
+        std::fprintf(stderr, "usage: %s [--records] audit.bin\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), {}};
+    size_t capacity = std::max<size_t>(bytes.size() / sizeof(AuditRecord), 1);
+    auto ring = AuditRing::deserialize(bytes, capacity);
+    if (!ring) {
+        std::fprintf(stderr, "%s is not an audit log\n", path);
+        return 1;
+    }
+
+    if (records) ring->forEach(printRecord);
+    else summarize(*ring);
+    return 0;
+}
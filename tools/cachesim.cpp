@@ -0,0 +1,634 @@
+// Replays level-open traces against cache policies to compare eviction, TTL
+// and prefetch choices for the verifier cache before shipping them.
+//
+//   verifier-cachesim (--audit <audit.bin> | --zipf <keys>) [options]
+//
+// Trace:
+//   --audit <file>        lookups recorded by the mod's audit log
+//   --zipf <keys>         synthetic: Zipf-distributed opens over <keys> levels
+//     --requests <n>      opens to generate (default 1000000)
+//     --alpha <a>         skew (default 0.9)
+//     --days <d>          trace length (default 7)
+//     --update-rate <r>   changes per level per day (default 0.02)
+//
+// Policies (every combination of the selected ones is run):
+//   --policy <lru|clock|tinylfu|all>   (default all)
+//   --capacity <n>        entries (default 256)
+//   --ttl <s>             base TTL (default 1800, CACHE_EXPIRY)
+//   --max-ttl <s>         cap for the adaptive TTL (default 86400)
+//   --prefetch            also run with refresh-ahead
+//   --adaptive            also run with an adaptive TTL
+//   --entry-bytes <n>     memory per resident entry (default 128)
+//   --interval <s>        print hit ratio, fetches and memory per window
+//
+// Miss-ratio curve:
+//   --mrc                 LRU miss ratio by capacity, without TTL
+//   --sample-rate <r>     SHARDS spatial sampling rate (default 0.01; 1 = exact)
+//
+// Audit traces carry no data changes, so stale serves are only counted for
+// synthetic ones, and an adaptive TTL there only ever grows.
+
+#include "core/AuditLog.hpp"
+#include "core/LevelKey.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Refresh-ahead fires on a hit this far into the entry's TTL.
+static constexpr double PREFETCH_AT = 0.8;
+// SHARDS hashes keys into this many buckets; a key is sampled if its bucket
+// is below rate * SHARDS_MODULUS.
+static constexpr uint32_t SHARDS_MODULUS = 1u << 24;
+
+struct Event {
+    uint32_t time;
+    uint32_t key;
+    bool update; // the level's data changed; otherwise a lookup
+};
+
+static uint32_t mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// --- Traces ---
+
+// Lookups are the decisions the mod makes on entering resolveLevel(); the
+// others follow from them.
+static bool isLookup(AuditDecision decision) {
+    switch (decision) {
+        case AuditDecision::CacheHit:
+        case AuditDecision::LocalUnlisted:
+        case AuditDecision::Joined:
+        case AuditDecision::Queued:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool readAuditTrace(char const* path, std::vector<Event>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), {}};
+    auto ring = AuditRing::deserialize(bytes, std::max<size_t>(bytes.size() / sizeof(AuditRecord), 1));
+    if (!ring) {
+        std::fprintf(stderr, "%s is not an audit log\n", path);
+        return false;
+    }
+    ring->forEach([&](AuditRecord const& r) {
+        if (isLookup(r.decision)) out.push_back({r.time, r.key, false});
+    });
+    return true;
+}
+
+static void makeZipfTrace(size_t keys, size_t requests, double alpha, double days, double updateRate, std::vector<Event>& out) {
+    std::vector<double> weights(keys);
+    for (size_t i = 0; i < keys; ++i) weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), alpha);
+    std::discrete_distribution<size_t> rank(weights.begin(), weights.end());
+    std::mt19937 rng(95);
+
+    auto duration = static_cast<uint32_t>(days * 86400);
+    std::uniform_int_distribution<uint32_t> when(0, duration);
+    auto key = [](size_t r) {
+        return packLevelKey(static_cast<int>(1000 + r / 2), r % 2);
+    };
+
+    for (size_t i = 0; i < requests; ++i) out.push_back({when(rng), key(rank(rng)), false});
+    auto updates = static_cast<size_t>(keys * updateRate * days);
+    std::uniform_int_distribution<size_t> anyKey(0, keys - 1);
+    for (size_t i = 0; i < updates; ++i) out.push_back({when(rng), key(anyKey(rng)), true});
+    std::ranges::stable_sort(out, {}, &Event::time);
+}
+
+// --- Eviction policies ---
+
+class Policy {
+public:
+    virtual ~Policy() = default;
+    virtual char const* name() const = 0;
+    // A lookup. True if `key` is resident; either way it counts as a use.
+    virtual bool access(uint32_t key) = 0;
+    // After a miss. The policy may decline to admit it.
+    virtual void insert(uint32_t key) = 0;
+    virtual size_t size() const = 0;
+};
+
+class LruList {
+public:
+    bool contains(uint32_t key) const {
+        return m_index.contains(key);
+    }
+    void pushFront(uint32_t key) {
+        m_order.push_front(key);
+        m_index[key] = m_order.begin();
+    }
+    void moveToFront(uint32_t key) {
+        m_order.splice(m_order.begin(), m_order, m_index.at(key));
+    }
+    uint32_t back() const {
+        return m_order.back();
+    }
+    uint32_t popBack() {
+        auto key = m_order.back();
+        m_order.pop_back();
+        m_index.erase(key);
+        return key;
+    }
+    void erase(uint32_t key) {
+        auto it = m_index.find(key);
+        m_order.erase(it->second);
+        m_index.erase(it);
+    }
+    size_t size() const {
+        return m_order.size();
+    }
+    bool empty() const {
+        return m_order.empty();
+    }
+
+private:
+    std::list<uint32_t> m_order;
+    std::unordered_map<uint32_t, std::list<uint32_t>::iterator> m_index;
+};
+
+class LruPolicy final : public Policy {
+public:
+    explicit LruPolicy(size_t capacity) : m_capacity(capacity) {}
+
+    char const* name() const override {
+        return "lru";
+    }
+    bool access(uint32_t key) override {
+        if (!m_list.contains(key)) return false;
+        m_list.moveToFront(key);
+        return true;
+    }
+    void insert(uint32_t key) override {
+        if (m_list.size() >= m_capacity) m_list.popBack();
+        m_list.pushFront(key);
+    }
+    size_t size() const override {
+        return m_list.size();
+    }
+
+private:
+    size_t m_capacity;
+    LruList m_list;
+};
+
+// Second chance: a hand sweeps the slots, clearing reference bits, and
+// replaces the first entry that wasn't used since the last sweep.
+class ClockPolicy final : public Policy {
+public:
+    explicit ClockPolicy(size_t capacity) : m_capacity(capacity) {}
+
+    char const* name() const override {
+        return "clock";
+    }
+    bool access(uint32_t key) override {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        m_slots[it->second].referenced = true;
+        return true;
+    }
+    void insert(uint32_t key) override {
+        if (m_slots.size() < m_capacity) {
+            m_index[key] = m_slots.size();
+            m_slots.push_back({key, false});
+            return;
+        }
+        while (m_slots[m_hand].referenced) {
+            m_slots[m_hand].referenced = false;
+            m_hand = (m_hand + 1) % m_slots.size();
+        }
+        m_index.erase(m_slots[m_hand].key);
+        m_slots[m_hand] = {key, false};
+        m_index[key] = m_hand;
+        m_hand = (m_hand + 1) % m_slots.size();
+    }
+    size_t size() const override {
+        return m_slots.size();
+    }
+
+private:
+    struct Slot {
+        uint32_t key;
+        bool referenced;
+    };
+    size_t m_capacity;
+    size_t m_hand = 0;
+    std::vector<Slot> m_slots;
+    std::unordered_map<uint32_t, size_t> m_index;
+};
+
+// 4-bit count-min sketch that halves every counter after `resetAfter`
+// increments, so frequencies follow the recent past.
+class FrequencySketch {
+public:
+    explicit FrequencySketch(size_t capacity) : m_resetAfter(std::max<size_t>(capacity, 16) * 10) {
+        size_t width = 16;
+        while (width < capacity * 2) width <<= 1;
+        m_mask = width - 1;
+        for (auto& row : m_rows) row.assign(width, 0);
+    }
+
+    void increment(uint32_t key) {
+        for (size_t i = 0; i < m_rows.size(); ++i) {
+            auto& counter = m_rows[i][slot(key, i)];
+            if (counter < 15) ++counter;
+        }
+        if (++m_additions >= m_resetAfter) {
+            for (auto& row : m_rows) {
+                for (auto& counter : row) counter >>= 1;
+            }
+            m_additions /= 2;
+        }
+    }
+
+    uint8_t estimate(uint32_t key) const {
+        uint8_t result = 15;
+        for (size_t i = 0; i < m_rows.size(); ++i) result = std::min(result, m_rows[i][slot(key, i)]);
+        return result;
+    }
+
+private:
+    size_t slot(uint32_t key, size_t row) const {
+        return mix32(key + 0x9e3779b9u * static_cast<uint32_t>(row + 1)) & m_mask;
+    }
+
+    std::array<std::vector<uint8_t>, 4> m_rows;
+    size_t m_mask;
+    size_t m_resetAfter;
+    size_t m_additions = 0;
+};
+
+// W-TinyLFU: a 1% LRU window in front of a segmented LRU (20% probation, 80%
+// protected). A key leaving the window only replaces the main cache's victim
+// if the sketch has seen it more often.
+class TinyLfuPolicy final : public Policy {
+public:
+    explicit TinyLfuPolicy(size_t capacity) : m_sketch(capacity) {
+        m_windowCapacity = std::max<size_t>(1, capacity / 100);
+        size_t main = capacity > m_windowCapacity ? capacity - m_windowCapacity : 1;
+        m_protectedCapacity = main * 8 / 10;
+        m_mainCapacity = main;
+    }
+
+    char const* name() const override {
+        return "tinylfu";
+    }
+    bool access(uint32_t key) override {
+        m_sketch.increment(key);
+        if (m_window.contains(key)) {
+            m_window.moveToFront(key);
+            return true;
+        }
+        if (m_protected.contains(key)) {
+            m_protected.moveToFront(key);
+            return true;
+        }
+        if (m_probation.contains(key)) {
+            m_probation.erase(key);
+            m_protected.pushFront(key);
+            if (m_protected.size() > m_protectedCapacity) m_probation.pushFront(m_protected.popBack());
+            return true;
+        }
+        return false;
+    }
+    void insert(uint32_t key) override {
+        m_window.pushFront(key);
+        if (m_window.size() <= m_windowCapacity) return;
+
+        auto candidate = m_window.popBack();
+        if (m_probation.size() + m_protected.size() < m_mainCapacity) {
+            m_probation.pushFront(candidate);
+            return;
+        }
+        auto& victims = m_probation.empty() ? m_protected : m_probation;
+        if (m_sketch.estimate(candidate) > m_sketch.estimate(victims.back())) {
+            victims.popBack();
+            m_probation.pushFront(candidate);
+        }
+    }
+    size_t size() const override {
+        return m_window.size() + m_probation.size() + m_protected.size();
+    }
+
+private:
+    FrequencySketch m_sketch;
+    size_t m_windowCapacity;
+    size_t m_mainCapacity;
+    size_t m_protectedCapacity;
+    LruList m_window;
+    LruList m_probation;
+    LruList m_protected;
+};
+
+static std::unique_ptr<Policy> makePolicy(std::string_view name, size_t capacity) {
+    if (name == "lru") return std::make_unique<LruPolicy>(capacity);
+    if (name == "clock") return std::make_unique<ClockPolicy>(capacity);
+    if (name == "tinylfu") return std::make_unique<TinyLfuPolicy>(capacity);
+    return nullptr;
+}
+
+// --- Simulation ---
+
+struct SimOptions {
+    size_t capacity = 256;
+    uint32_t ttl = 1800;
+    uint32_t maxTtl = 86400;
+    bool adaptive = false;
+    bool prefetch = false;
+    size_t entryBytes = 128;
+    uint32_t interval = 0;
+};
+
+struct Window {
+    size_t lookups = 0;
+    size_t hits = 0;
+    size_t fetches = 0;
+};
+
+struct SimResult {
+    size_t lookups = 0;
+    size_t hits = 0;
+    size_t misses = 0;  // not resident
+    size_t expired = 0; // resident but past its TTL
+    size_t prefetches = 0;
+    size_t staleServes = 0;
+    size_t peakEntries = 0;
+
+    size_t fetches() const {
+        return misses + expired + prefetches;
+    }
+};
+
+static SimResult simulate(std::vector<Event> const& trace, Policy& policy, SimOptions const& opt) {
+    struct Meta {
+        uint32_t fetchedAt = 0;
+        uint32_t ttl = 0;
+        uint32_t fetchedVersion = 0;
+    };
+    std::unordered_map<uint32_t, Meta> meta;
+    std::unordered_map<uint32_t, uint32_t> versions;
+    SimResult result;
+    Window window;
+    uint32_t windowStart = trace.empty() ? 0 : trace.front().time;
+
+    // An adaptive TTL doubles while refetches find nothing new and drops back
+    // to the base TTL once one does.
+    auto fetch = [&](uint32_t key, uint32_t now, Meta& m, bool refetch) {
+        auto version = versions[key];
+        if (!opt.adaptive || m.ttl == 0) m.ttl = opt.ttl;
+        else if (refetch) m.ttl = version == m.fetchedVersion ? std::min(opt.maxTtl, m.ttl * 2) : opt.ttl;
+        m.fetchedAt = now;
+        m.fetchedVersion = version;
+        ++window.fetches;
+    };
+
+    auto flushWindow = [&](uint32_t now) {
+        if (!opt.interval) return;
+        while (now - windowStart >= opt.interval) {
+            if (window.lookups) {
+                std::printf(
+                    "    t+%-8u %6zu lookups  hit %5.1f%%  %5zu fetches  %5zu entries  %7.1f KB\n",
+                    windowStart - trace.front().time, window.lookups, 100.0 * window.hits / window.lookups,
+                    window.fetches, policy.size(), policy.size() * opt.entryBytes / 1024.0
+                );
+            }
+            window = {};
+            windowStart += opt.interval;
+        }
+    };
+
+    for (auto const& e : trace) {
+        flushWindow(e.time);
+        if (e.update) {
+            ++versions[e.key];
+            continue;
+        }
+
+        ++result.lookups;
+        ++window.lookups;
+        auto& m = meta[e.key];
+        if (!policy.access(e.key)) {
+            ++result.misses;
+            fetch(e.key, e.time, m, false);
+            policy.insert(e.key);
+        }
+        else if (e.time - m.fetchedAt > m.ttl) {
+            ++result.expired;
+            fetch(e.key, e.time, m, true);
+        }
+        else {
+            ++result.hits;
+            ++window.hits;
+            if (m.fetchedVersion != versions[e.key]) ++result.staleServes;
+            if (opt.prefetch && e.time - m.fetchedAt >= m.ttl * PREFETCH_AT) {
+                ++result.prefetches;
+                fetch(e.key, e.time, m, true);
+            }
+        }
+        result.peakEntries = std::max(result.peakEntries, policy.size());
+    }
+    if (!trace.empty()) flushWindow(trace.back().time + opt.interval);
+    return result;
+}
+
+// --- Miss-ratio curve ---
+
+// Fenwick tree over trace positions marking each key's latest access, so the
+// distinct keys touched since a key's previous access is a range sum.
+class Fenwick {
+public:
+    explicit Fenwick(size_t n) : m_tree(n + 1) {}
+
+    void add(size_t i, int delta) {
+        for (++i; i < m_tree.size(); i += i & (~i + 1)) m_tree[i] += delta;
+    }
+    // Sum over [0, i).
+    int prefix(size_t i) const {
+        int sum = 0;
+        for (; i > 0; i -= i & (~i + 1)) sum += m_tree[i];
+        return sum;
+    }
+
+private:
+    std::vector<int> m_tree;
+};
+
+// SHARDS: stack distances over only the keys whose hash falls in the sample,
+// scaled up by 1/rate. The sampled count is corrected toward the expected
+// one (SHARDS-adj) by crediting the difference to the smallest distance.
+static void printMissRatioCurve(std::vector<Event> const& trace, double rate) {
+    auto threshold = static_cast<uint32_t>(rate * SHARDS_MODULUS);
+    std::vector<uint32_t> sampled;
+    size_t lookups = 0;
+    for (auto const& e : trace) {
+        if (e.update) continue;
+        ++lookups;
+        if ((mix32(e.key) & (SHARDS_MODULUS - 1)) < threshold) sampled.push_back(e.key);
+    }
+    if (sampled.empty()) {
+        std::printf("\nMiss ratio curve: no keys sampled, raise --sample-rate\n");
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Fenwick marks(sampled.size());
+    std::unordered_map<uint32_t, size_t> last;
+    std::vector<double> distances;
+    size_t cold = 0;
+    for (size_t i = 0; i < sampled.size(); ++i) {
+        auto [it, first] = last.try_emplace(sampled[i], i);
+        if (first) {
+            ++cold;
+        }
+        else {
+            auto previous = it->second;
+            auto distinct = marks.prefix(i) - marks.prefix(previous + 1);
+            distances.push_back(distinct / rate);
+            marks.add(previous, -1);
+            it->second = i;
+        }
+        marks.add(i, 1);
+    }
+    std::ranges::sort(distances);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    double expected = lookups * rate;
+    double adjustment = expected - static_cast<double>(sampled.size());
+    std::printf(
+        "\nLRU miss ratio curve, no TTL (SHARDS rate %g: %zu of %zu lookups, %zu keys, %.1f ms)\n", rate,
+        sampled.size(), lookups, last.size(), elapsed.count()
+    );
+    // Sampled distances below 1/rate can't be told apart, so start there.
+    size_t smallest = 1;
+    while (smallest * rate < 1) smallest *= 2;
+    auto keys = static_cast<size_t>(last.size() / rate);
+    for (size_t capacity = smallest; ; capacity *= 2) {
+        auto within = std::ranges::lower_bound(distances, static_cast<double>(capacity)) - distances.begin();
+        double hits = static_cast<double>(within) + adjustment;
+        double missRatio = std::clamp(1.0 - hits / expected, 0.0, 1.0);
+        std::printf("  %8zu entries  miss %5.1f%%\n", capacity, 100.0 * missRatio);
+        if (capacity >= keys) break;
+    }
+    std::printf("  cold misses alone: %.1f%%\n", 100.0 * std::min(1.0, cold / expected));
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(stderr,
+        "usage: %s (--audit <audit.bin> | --zipf <keys>) [--requests <n>] [--alpha <a>] [--days <d>]\n"
+        "       [--update-rate <r>] [--policy <lru|clock|tinylfu|all>] [--capacity <n>] [--ttl <s>]\n"
+        "       [--max-ttl <s>] [--adaptive] [--prefetch] [--entry-bytes <n>] [--interval <s>]\n"
+        "       [--mrc] [--sample-rate <r>]\n",
+        argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::unordered_map<std::string_view, char const*> flags;
+    bool adaptive = false, prefetch = false, mrc = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--adaptive") adaptive = true;
+        else if (arg == "--prefetch") prefetch = true;
+        else if (arg == "--mrc") mrc = true;
+        else if (arg.starts_with("--") && i + 1 < argc) flags[arg] = argv[++i];
+        else return usage(argv[0]);
+    }
+    auto number = [&](std::string_view name, double fallback) {
+        auto it = flags.find(name);
+        return it == flags.end() ? fallback : std::strtod(it->second, nullptr);
+    };
+
+    std::vector<Event> trace;
+    if (auto audit = flags.find("--audit"); audit != flags.end()) {
+        if (!readAuditTrace(audit->second, trace)) return 1;
+    }
+    else if (flags.contains("--zipf")) {
+        auto keys = static_cast<size_t>(number("--zipf", 0));
+        if (keys == 0) return usage(argv[0]);
+        makeZipfTrace(
+            keys, static_cast<size_t>(number("--requests", 1'000'000)), number("--alpha", 0.9), number("--days", 7),
+            number("--update-rate", 0.02), trace
+        );
+    }
+    else {
+        return usage(argv[0]);
+    }
+    if (trace.empty()) {
+        std::fprintf(stderr, "trace has no lookups\n");
+        return 1;
+    }
+
+    SimOptions base;
+    base.capacity = static_cast<size_t>(number("--capacity", 256));
+    base.ttl = static_cast<uint32_t>(number("--ttl", 1800));
+    base.maxTtl = static_cast<uint32_t>(number("--max-ttl", 86400));
+    base.entryBytes = static_cast<size_t>(number("--entry-bytes", 128));
+    base.interval = static_cast<uint32_t>(number("--interval", 0));
+    if (base.capacity == 0 || base.ttl == 0) return usage(argv[0]);
+
+    std::vector<std::string_view> policies = {"lru", "clock", "tinylfu"};
+    if (auto it = flags.find("--policy"); it != flags.end() && std::string_view(it->second) != "all") {
+        if (!makePolicy(it->second, 1)) return usage(argv[0]);
+        policies = {it->second};
+    }
+
+    std::printf(
+        "%zu events over %.1f days; capacity %zu, ttl %us\n\n", trace.size(),
+        (trace.back().time - trace.front().time) / 86400.0, base.capacity, base.ttl
+    );
+    std::printf(
+        "  %-8s %-9s %-8s %7s %9s %9s %9s %9s %8s %9s\n", "policy", "ttl", "prefetch", "hit", "fetches",
+        "expired", "prefetch", "stale", "peak", "peak KB"
+    );
+
+    for (auto name : policies) {
+        for (bool adapt : {false, true}) {
+            if (adapt && !adaptive) continue;
+            for (bool ahead : {false, true}) {
+                if (ahead && !prefetch) continue;
+                auto opt = base;
+                opt.adaptive = adapt;
+                opt.prefetch = ahead;
+                auto policy = makePolicy(name, opt.capacity);
+                if (opt.interval) {
+                    std::printf("  %s, %s ttl, prefetch %s\n", policy->name(), adapt ? "adaptive" : "fixed", ahead ? "on" : "off");
+                }
+                auto r = simulate(trace, *policy, opt);
+                std::printf(
+                    "  %-8s %-9s %-8s %6.1f%% %9zu %9zu %9zu %9zu %8zu %9.1f\n", policy->name(),
+                    adapt ? "adaptive" : "fixed", ahead ? "on" : "off", 100.0 * r.hits / r.lookups, r.fetches(),
+                    r.expired, r.prefetches, r.staleServes, r.peakEntries, r.peakEntries * opt.entryBytes / 1024.0
+                );
+            }
+        }
+    }
+
+    if (mrc) printMissRatioCurve(trace, std::clamp(number("--sample-rate", 0.01), 1e-6, 1.0));
+    return 0;
+}
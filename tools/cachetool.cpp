@@ -0,0 +1,368 @@
+// Inspects, repairs, converts and times verifier cache files off-device,
+// using the same parser and encoders as the mod.
+//
+//   verifier-cachetool stats <file>
+//   verifier-cachetool validate <file> [--repair <out>]
+//   verifier-cachetool convert <in> <out>
+//   verifier-cachetool compact <in> <out> [--max-age <days>]
+//   verifier-cachetool time <file> [--iterations <n>] [--hot <n>]
+//
+// Inputs may be JSON or binary; outputs ending in .bin are written as binary,
+// anything else as JSON. compact writes entries hottest first, as the mod
+// does, and time compares having the hottest --hot entries usable through
+// the mod's staged load against a full load.
+
+#include "core/CacheFile.hpp"
+#include "core/LevelKey.hpp"
+#include "core/ResponseReducer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Mirrors CACHE_EXPIRY in the mod.
+static constexpr long long CACHE_EXPIRY = 1800;
+
+struct LoadedCache {
+    std::vector<CacheEntry> entries; // last one wins for duplicate keys, like loadCache()
+    std::vector<std::string> invalidKeys;
+    size_t duplicates = 0;
+    bool complete = true;
+    bool binary = false;
+};
+
+static bool readFile(char const* path, std::vector<uint8_t>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), {});
+    return true;
+}
+
+static bool writeFile(char const* path, void const* data, size_t size) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    return out && out.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+}
+
+static LoadedCache parseCache(std::span<uint8_t const> bytes) {
+    LoadedCache loaded;
+    if (isBinaryCache(bytes)) {
+        loaded.binary = true;
+        auto entries = decodeBinaryCache(bytes);
+        loaded.complete = entries.has_value();
+        if (entries) loaded.entries = std::move(*entries);
+        return loaded;
+    }
+
+    std::unordered_map<uint32_t, size_t> index;
+    std::string_view json(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+    loaded.complete = reduceCacheFile(json, [&](std::string_view k, VerifierData data) {
+        auto key = parseLevelKey(k);
+        if (!key) {
+            loaded.invalidKeys.emplace_back(k);
+            return;
+        }
+        auto [it, inserted] = index.try_emplace(*key, loaded.entries.size());
+        if (inserted) {
+            loaded.entries.push_back({*key, std::move(data)});
+        }
+        else {
+            ++loaded.duplicates;
+            loaded.entries[it->second].data = std::move(data);
+        }
+    });
+    return loaded;
+}
+
+static bool loadCacheFile(char const* path, LoadedCache& loaded, std::vector<uint8_t>* raw = nullptr) {
+    std::vector<uint8_t> bytes;
+    if (!readFile(path, bytes)) {
+        std::fprintf(stderr, "cannot read %s\n", path);
+        return false;
+    }
+    loaded = parseCache(bytes);
+    if (raw) *raw = std::move(bytes);
+    return true;
+}
+
+static bool saveCacheFile(char const* path, std::span<CacheEntry const> entries, size_t* written = nullptr) {
+    bool binary = std::string_view(path).ends_with(".bin");
+    bool ok;
+    size_t size;
+    if (binary) {
+        auto bytes = encodeBinaryCache(entries);
+        size = bytes.size();
+        ok = writeFile(path, bytes.data(), size);
+    }
+    else {
+        std::string json;
+        writeJsonCache(json, entries);
+        size = json.size();
+        ok = writeFile(path, json.data(), size);
+    }
+    if (!ok) std::fprintf(stderr, "cannot write %s\n", path);
+    if (written) *written = size;
+    return ok;
+}
+
+static long long now() {
+    return static_cast<long long>(std::time(nullptr));
+}
+
+static int cmdStats(char const* path) {
+    LoadedCache loaded;
+    std::vector<uint8_t> raw;
+    if (!loadCacheFile(path, loaded, &raw)) return 1;
+
+    size_t negative = 0, expired = 0, legacy = 0, duo = 0, withVideo = 0;
+    size_t ageBuckets[4] = {}; // < expiry, < 1 day, < 7 days, older
+    size_t keyBytes = 0;
+    std::vector<std::pair<std::string_view, size_t>> fieldBytes;
+    forEachField<VerifierData>([&](auto const& f) { fieldBytes.emplace_back(f.name, 0); });
+    std::unordered_map<std::string_view, size_t> names;
+    auto t = now();
+
+    for (auto const& [key, d] : loaded.entries) {
+        auto age = t - d.timestamp;
+        if (d.verifier.empty()) ++negative;
+        if (age > CACHE_EXPIRY) ++expired;
+        if (d.legacy) ++legacy;
+        if (isDuoKey(key)) ++duo;
+        if (!d.video.empty()) ++withVideo;
+        ++ageBuckets[age <= CACHE_EXPIRY ? 0 : age <= 86400 ? 1 : age <= 7 * 86400 ? 2 : 3];
+        if (!d.verifier.empty()) ++names[d.verifier];
+
+        // As laid out in the JSON file: quotes, colon and separating comma.
+        keyBytes += formatLevelKey(key).size() + 4;
+        size_t field = 0;
+        forEachField<VerifierData>([&](auto const& f) {
+            std::string value;
+            writeJsonValue(value, d.*f.member);
+            fieldBytes[field++].second += f.name.size() + 4 + value.size();
+        });
+    }
+
+    std::printf("%s: %s, %zu bytes%s\n", path, loaded.binary ? "binary" : "JSON", raw.size(),
+        loaded.complete ? "" : " (malformed, partially read)");
+    std::printf("entries        %zu (%zu 2P)\n", loaded.entries.size(), duo);
+    std::printf("negative       %zu\n", negative);
+    std::printf("expired        %zu (older than %llds)\n", expired, CACHE_EXPIRY);
+    std::printf("legacy         %zu\n", legacy);
+    std::printf("with video     %zu\n", withVideo);
+    std::printf("age            <%llds %zu, <1d %zu, <7d %zu, older %zu\n",
+        CACHE_EXPIRY, ageBuckets[0], ageBuckets[1], ageBuckets[2], ageBuckets[3]);
+    if (!loaded.invalidKeys.empty()) std::printf("invalid keys   %zu\n", loaded.invalidKeys.size());
+    if (loaded.duplicates) std::printf("duplicate keys %zu\n", loaded.duplicates);
+
+    std::printf("\nJSON bytes by field\n");
+    std::printf("  %-12s %zu\n", "key", keyBytes);
+    for (auto const& [field, bytes] : fieldBytes) {
+        std::printf("  %-12.*s %zu\n", static_cast<int>(field.size()), field.data(), bytes);
+    }
+
+    size_t repeated = 0, savable = 0;
+    std::vector<std::pair<std::string_view, size_t>> top;
+    for (auto const& [name, count] : names) {
+        if (count < 2) continue;
+        repeated += count;
+        savable += (count - 1) * name.size();
+        top.emplace_back(name, count);
+    }
+    std::ranges::sort(top, [](auto const& a, auto const& b) { return a.second > b.second; });
+    std::printf("\nverifier names %zu distinct, %zu entries share a name (%zu bytes repeated)\n",
+        names.size(), repeated, savable);
+    for (size_t i = 0; i < std::min<size_t>(top.size(), 5); ++i) {
+        std::printf("  %-24s %zu\n", std::string(top[i].first).c_str(), top[i].second);
+    }
+    return 0;
+}
+
+static int cmdValidate(char const* path, char const* repairPath) {
+    LoadedCache loaded;
+    if (!loadCacheFile(path, loaded)) return 1;
+
+    size_t issues = 0;
+    if (!loaded.complete) {
+        std::printf("malformed: only the first %zu entries could be read\n", loaded.entries.size());
+        ++issues;
+    }
+    for (auto const& key : loaded.invalidKeys) {
+        std::printf("invalid key \"%s\"\n", key.c_str());
+        ++issues;
+    }
+    if (loaded.duplicates) {
+        std::printf("%zu duplicate keys (the last value is used)\n", loaded.duplicates);
+        issues += loaded.duplicates;
+    }
+
+    // Anything dated in the future would never expire.
+    auto t = now();
+    std::erase_if(loaded.entries, [&](CacheEntry const& e) {
+        bool bad = e.data.timestamp <= 0 || e.data.timestamp > t + 86400;
+        if (bad) {
+            std::printf("%s: bad timestamp %lld\n", formatLevelKey(e.key).c_str(), e.data.timestamp);
+            ++issues;
+        }
+        return bad;
+    });
+
+    if (!issues) std::printf("%s: OK, %zu entries\n", path, loaded.entries.size());
+    if (repairPath) {
+        if (!saveCacheFile(repairPath, loaded.entries)) return 1;
+        std::printf("wrote %zu valid entries to %s\n", loaded.entries.size(), repairPath);
+        return 0;
+    }
+    return issues ? 1 : 0;
+}
+
+static int cmdConvert(char const* in, char const* out) {
+    LoadedCache loaded;
+    if (!loadCacheFile(in, loaded)) return 1;
+    if (!loaded.complete) std::fprintf(stderr, "warning: %s is malformed, converting what could be read\n", in);
+    size_t written;
+    if (!saveCacheFile(out, loaded.entries, &written)) return 1;
+    std::printf("wrote %zu entries, %zu bytes to %s\n", loaded.entries.size(), written, out);
+    return 0;
+}
+
+// Drops what the mod would never serve again: negative entries past expiry
+// (they are cheap to learn again) and anything older than `maxAgeDays`.
+static int cmdCompact(char const* in, char const* out, long long maxAgeDays) {
+    LoadedCache loaded;
+    std::vector<uint8_t> raw;
+    if (!loadCacheFile(in, loaded, &raw)) return 1;
+
+    auto t = now();
+    auto before = loaded.entries.size();
+    std::erase_if(loaded.entries, [&](CacheEntry const& e) {
+        auto age = t - e.data.timestamp;
+        return age > maxAgeDays * 86400 || (e.data.verifier.empty() && age > CACHE_EXPIRY);
+    });
+    sortHottestFirst(loaded.entries, t);
+
+    size_t written;
+    if (!saveCacheFile(out, loaded.entries, &written)) return 1;
+    std::printf(
+        "kept %zu of %zu entries, %zu -> %zu bytes\n", loaded.entries.size(), before + loaded.duplicates,
+        raw.size(), written
+    );
+    return 0;
+}
+
+template <class F>
+static void timeIt(char const* label, int iterations, size_t bytes, F&& fn) {
+    std::vector<double> samples;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(elapsed.count());
+    }
+    std::ranges::sort(samples);
+    double median = samples[samples.size() / 2];
+    std::printf(
+        "  %-14s best %8.3f ms  median %8.3f ms  %7.1f MB/s\n", label, samples.front(), median,
+        bytes / 1e6 / (median / 1e3)
+    );
+}
+
+static int cmdTime(char const* path, int iterations, size_t hot) {
+    LoadedCache loaded;
+    std::vector<uint8_t> raw;
+    if (!loadCacheFile(path, loaded, &raw)) return 1;
+
+    sortHottestFirst(loaded.entries, now());
+    std::string json;
+    writeJsonCache(json, loaded.entries);
+    auto binary = encodeBinaryCache(loaded.entries);
+    std::printf(
+        "%zu entries; JSON %zu bytes, binary %zu bytes; %d iterations\n", loaded.entries.size(), json.size(),
+        binary.size(), iterations
+    );
+
+    // Load as loadCache() does: parse into a map keyed by packed key.
+    timeIt("load JSON", iterations, json.size(), [&] {
+        std::unordered_map<uint32_t, VerifierData> cache;
+        reduceCacheFile(json, [&](std::string_view k, VerifierData data) {
+            if (auto key = parseLevelKey(k)) cache[*key] = std::move(data);
+        });
+    });
+    // The mod's staged load, up to the point the hot head is usable. The mod
+    // hands over its file buffer; the copy made here counts against it.
+    auto hotLabel = "hot " + std::to_string(hot) + " JSON";
+    timeIt(hotLabel.c_str(), iterations, json.size(), [&] {
+        std::unordered_map<uint32_t, VerifierData> cache;
+        StagedCacheReader reader(json);
+        reader.read(hot, [&](uint32_t key, VerifierData data) { cache.try_emplace(key, std::move(data)); });
+    });
+    timeIt("save JSON", iterations, json.size(), [&] {
+        std::string out;
+        writeJsonCache(out, loaded.entries);
+    });
+    timeIt("load binary", iterations, binary.size(), [&] {
+        std::unordered_map<uint32_t, VerifierData> cache;
+        if (auto entries = decodeBinaryCache(binary)) {
+            for (auto& e : *entries) cache[e.key] = std::move(e.data);
+        }
+    });
+    timeIt("save binary", iterations, binary.size(), [&] { encodeBinaryCache(loaded.entries); });
+    return 0;
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(stderr,
+        "usage: %s stats <file>\n"
+        "       %s validate <file> [--repair <out>]\n"
+        "       %s convert <in> <out>\n"
+        "       %s compact <in> <out> [--max-age <days>]\n"
+        "       %s time <file> [--iterations <n>] [--hot <n>]\n",
+        argv0, argv0, argv0, argv0, argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage(argv[0]);
+    std::string_view cmd = argv[1];
+
+    // Positional arguments, then "--flag value" pairs.
+    std::vector<char const*> args;
+    std::unordered_map<std::string_view, char const*> flags;
+    for (int i = 2; i < argc; ++i) {
+        if (std::string_view(argv[i]).starts_with("--")) {
+            if (i + 1 >= argc) return usage(argv[0]);
+            flags[argv[i]] = argv[i + 1];
+            ++i;
+        }
+        else {
+            args.push_back(argv[i]);
+        }
+    }
+    auto flag = [&](std::string_view name) -> char const* {
+        auto it = flags.find(name);
+        return it == flags.end() ? nullptr : it->second;
+    };
+
+    if (cmd == "stats" && args.size() == 1) return cmdStats(args[0]);
+    if (cmd == "validate" && args.size() == 1) return cmdValidate(args[0], flag("--repair"));
+    if (cmd == "convert" && args.size() == 2) return cmdConvert(args[0], args[1]);
+    if (cmd == "compact" && args.size() == 2) {
+        auto maxAge = flag("--max-age");
+        return cmdCompact(args[0], args[1], maxAge ? std::atoll(maxAge) : 30);
+    }
+    if (cmd == "time" && args.size() == 1) {
+        auto iterations = flag("--iterations");
+        auto hot = flag("--hot");
+        return cmdTime(
+            args[0], std::max(iterations ? std::atoi(iterations) : 20, 1), hot ? std::strtoull(hot, nullptr, 10) : 100
+        );
+    }
+    return usage(argv[0]);
+}
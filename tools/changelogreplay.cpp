@@ -0,0 +1,213 @@
+// Replays changelog polls through the mod's changelog handling (the same
+// reduceChangelog() and ChangelogCursor.hpp) and shows what each poll does to
+// the entries of a cache file.
+//
+//   verifier-changelogreplay [--cache <file>] [--start <unix>] [--interval <s>]
+//                            <poll.json>...
+//   verifier-changelogreplay --check
+//
+// Each poll.json is one changelog response as the API sent it, in poll order,
+// replayed --interval seconds apart (CHANGELOG_POLL_INTERVAL by default) from
+// --start (default: the newest entry in the cache, or now). One that doesn't
+// parse counts as a failed poll: the cursor stays put and the feed isn't
+// marked as polled. After each poll the cache's entries are counted as fresh,
+// covered by the changelog, invalidated or expired. --check replays a fixed
+// sequence and verifies the result.
+
+#include "core/CacheFile.hpp"
+#include "core/ChangelogCursor.hpp"
+#include "core/LevelKey.hpp"
+#include "core/ResponseReducer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Mirrors CACHE_EXPIRY in the mod.
+static constexpr long long CACHE_EXPIRY = 1800;
+
+// One feed, followed the way Changelog.cpp follows each list's.
+struct Feed {
+    std::string cursor;
+    long long lastPoll = 0;
+    long long trackingSince = 0;
+
+    // nullopt if the response doesn't parse.
+    std::optional<ChangelogPoll> poll(std::string_view response, long long now) {
+        auto entries = reduceChangelog(response);
+        if (!entries) return std::nullopt;
+        auto result = applyChangelog(cursor, *entries);
+        if (result.gap) trackingSince = now;
+        cursor = result.cursor;
+        lastPoll = now;
+        return result;
+    }
+
+    bool covers(long long timestamp, long long now) const {
+        long long lastPolls[] = {lastPoll};
+        return isCoveredByChangelog(timestamp, now, trackingSince, lastPolls);
+    }
+};
+
+static std::optional<std::string> readFile(char const* path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+static std::optional<std::vector<CacheEntry>> readCache(char const* path) {
+    auto text = readFile(path);
+    if (!text) return std::nullopt;
+    auto bytes = std::span(reinterpret_cast<uint8_t const*>(text->data()), text->size());
+    if (isBinaryCache(bytes)) return decodeBinaryCache(bytes);
+    std::vector<CacheEntry> entries;
+    bool ok = reduceCacheFile(*text, [&](std::string_view k, VerifierData data) {
+        if (auto key = parseLevelKey(k)) entries.push_back({*key, std::move(data)});
+    });
+    if (!ok) return std::nullopt;
+    return entries;
+}
+
+static int replay(
+    std::vector<char const*> const& polls, std::vector<CacheEntry> const& cache, long long start, long long interval
+) {
+    Feed feed;
+    std::unordered_set<int> invalidated;
+    auto now = start;
+    int failures = 0;
+
+    for (auto path : polls) {
+        auto response = readFile(path);
+        auto result = response ? feed.poll(*response, now) : std::nullopt;
+        if (!result) {
+            std::printf("%lld %s: failed\n", now, path);
+            ++failures;
+        }
+        else {
+            std::printf(
+                "%lld %s: %zu levels changed, cursor %s%s\n", now, path, result->changed.size(),
+                result->cursor.empty() ? "(none)" : result->cursor.c_str(), result->gap ? ", gap: tracking restarts" : ""
+            );
+            invalidated.insert(result->changed.begin(), result->changed.end());
+        }
+
+        if (!cache.empty()) {
+            size_t fresh = 0, covered = 0, dropped = 0, expired = 0;
+            for (auto const& entry : cache) {
+                if (invalidated.contains(levelIDFromKey(entry.key))) ++dropped;
+                else if (now - entry.data.timestamp <= CACHE_EXPIRY) ++fresh;
+                else if (feed.covers(entry.data.timestamp, now)) ++covered;
+                else ++expired;
+            }
+            std::printf(
+                "    %zu fresh, %zu covered, %zu invalidated, %zu expired\n", fresh, covered, dropped, expired
+            );
+        }
+        now += interval;
+    }
+    return failures ? 1 : 0;
+}
+
+static int s_failed = 0;
+
+static void expect(bool ok, char const* what) {
+    std::printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) ++s_failed;
+}
+
+static int check() {
+    constexpr long long T = 1'700'000'000;
+    Feed feed;
+
+    auto first = feed.poll(R"([{"created_at":"2024-01-02","affected_level":{"level_id":1}}])", T);
+    expect(first && first->gap && feed.trackingSince == T, "the first poll starts tracking");
+    expect(first && first->cursor == "2024-01-02", "the cursor moves to the newest change");
+
+    auto second = feed.poll(
+        R"({"data":[{"created_at":"2024-01-03","level_above":{"level_id":3},"level_below":{"level_id":4}},)"
+        R"({"created_at":"2024-01-02","affected_level":{"level_id":1}}]})",
+        T + 600
+    );
+    expect(second && !second->gap, "a poll reaching back to the cursor has no gap");
+    expect(second && second->changed == std::vector<int>{3, 4}, "only changes after the cursor invalidate");
+    expect(feed.covers(T + 10, T + 600), "an entry fetched since tracking started is covered");
+    expect(!feed.covers(T - 10, T + 600), "an entry fetched before tracking started isn't");
+
+    expect(!feed.poll("<html>502</html>", T + 1200), "an unreadable response is a failed poll");
+    expect(feed.cursor == "2024-01-03", "a failed poll leaves the cursor");
+    expect(feed.covers(T + 10, T + 1300), "a recent good poll still vouches after a failed one");
+    expect(
+        !feed.covers(T + 10, T + 601 + CHANGELOG_TRUST_WINDOW), "coverage lapses once the last good poll is too old"
+    );
+
+    auto empty = feed.poll("[]", T + 1800);
+    expect(empty && !empty->gap && empty->changed.empty(), "an empty poll has no gap");
+    expect(feed.covers(T + 10, T + 1800), "a good poll restores coverage");
+    long long late = T + 10 + CHANGELOG_MAX_AGE + 1;
+    long long polledNow[] = {late};
+    expect(!isCoveredByChangelog(T + 10, late, feed.trackingSince, polledNow), "coverage ends at CHANGELOG_MAX_AGE");
+
+    auto skipped = feed.poll(R"([{"created_at":"2024-01-09","affected_level":{"level_id":5}}])", T + 2400);
+    expect(skipped && skipped->gap && feed.trackingSince == T + 2400, "a poll past the cursor restarts tracking");
+    expect(!feed.covers(T + 10, T + 2400), "entries from before the gap aren't covered");
+
+    std::printf("%s\n", s_failed ? "FAILED" : "all passed");
+    return s_failed ? 1 : 0;
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(
+        stderr,
+        "usage: %s [--cache <file>] [--start <unix>] [--interval <s>] <poll.json>...\n"
+        "       %s --check\n",
+        argv0, argv0
+    );
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    char const* cachePath = nullptr;
+    std::optional<long long> start;
+    long long interval = CHANGELOG_POLL_INTERVAL;
+    std::vector<char const*> polls;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--check") return check();
+        if (arg == "--cache" || arg == "--start" || arg == "--interval") {
+            if (i + 1 >= argc) return usage(argv[0]);
+            char const* value = argv[++i];
+            if (arg == "--cache") cachePath = value;
+            else if (arg == "--start") start = std::strtoll(value, nullptr, 10);
+            else interval = std::strtoll(value, nullptr, 10);
+        }
+        else if (arg.starts_with("--")) return usage(argv[0]);
+        else polls.push_back(argv[i]);
+    }
+    if (polls.empty()) return usage(argv[0]);
+
+    std::vector<CacheEntry> cache;
+    if (cachePath) {
+        auto entries = readCache(cachePath);
+        if (!entries) {
+            std::fprintf(stderr, "cannot read cache file %s\n", cachePath);
+            return 1;
+        }
+        cache = std::move(*entries);
+    }
+    if (!start) {
+        long long newest = 0;
+        for (auto const& entry : cache) newest = std::max(newest, entry.data.timestamp);
+        start = newest ? newest : static_cast<long long>(std::time(nullptr));
+    }
+    return replay(polls, cache, *start, interval);
+}
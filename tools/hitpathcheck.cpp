@@ -0,0 +1,155 @@
+// Checks that the core half of the level page's cache-hit path doesn't
+// allocate: the cache lookup under the mod's expiry (CacheExpiry, including
+// changelog coverage), counting the hit and the access, and formatting the
+// label (main.cpp's refreshLabel() and applyData()). Operator new is
+// replaced with a counting one, and any allocation in the path fails the
+// check. Also checks that long names are cut between UTF-8 code points.
+//
+//   verifier-hitpathcheck
+
+#include "core/CacheExpiry.hpp"
+#include "core/LevelKey.hpp"
+#include "core/Metrics.hpp"
+#include "core/StagedCache.hpp"
+#include "core/TtlCache.hpp"
+#include "core/VerifierLabel.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+
+static size_t s_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++s_allocations;
+    if (auto p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static constexpr long long NOW = 1'700'000'000;
+
+// Stands in for the mod's settings and changelog feeds.
+static bool s_sessionOnly = false;
+static long long s_trackingSince = 0;
+static long long s_lastPolls[2] = {};
+
+struct CheckExpiryState {
+    bool sessionOnly() const {
+        return s_sessionOnly;
+    }
+    long long trackingSince() const {
+        return s_trackingSince;
+    }
+    std::span<long long const> lastPolls() const {
+        return s_lastPolls;
+    }
+};
+
+using Store = ttl::TtlCache<
+    uint32_t, VerifierData, ttl::NoCodec, ttl::OldestEviction<uint32_t>, CacheExpiry<CheckExpiryState>,
+    ttl::StringPersistence
+>;
+
+static Counter s_hits{"hits", "cache hits"};
+static int s_failed = 0;
+
+static void expect(bool ok, char const* what) {
+    std::printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) ++s_failed;
+}
+
+// Like refreshLabel() on a hit: find, count, format. Returns the allocations
+// made.
+static size_t hit(StagedCache<Store>& store, uint32_t key, bool twoPlayer, VerifierLabel& text) {
+    auto before = s_allocations;
+    auto data = store.cache().find(key, NOW);
+    if (!data) return SIZE_MAX;
+    s_hits.add();
+    store.recordAccess(key, NOW);
+    formatVerifierLabel(text, data->verifier, isDuoKey(key), twoPlayer);
+    return s_allocations - before;
+}
+
+// True if `text` doesn't end partway through a UTF-8 sequence.
+static bool endsOnCodePoint(std::string_view text) {
+    size_t i = text.size();
+    size_t continuation = 0;
+    while (i > 0 && (static_cast<unsigned char>(text[i - 1]) & 0xc0) == 0x80) {
+        --i;
+        ++continuation;
+    }
+    if (i == 0) return continuation == 0;
+    auto lead = static_cast<unsigned char>(text[i - 1]);
+    size_t expected = lead < 0x80 ? 0 : lead >= 0xf0 ? 3 : lead >= 0xe0 ? 2 : 1;
+    return continuation == expected;
+}
+
+int main() {
+    StagedCache<Store> store;
+    store.cache().eviction().setCapacity(1000);
+    std::string longAscii(300, 'x');
+    std::string longAccented;
+    while (longAccented.size() < 300) longAccented += "\xc3\xa9"; // é
+    std::string longEmoji;
+    while (longEmoji.size() < 300) longEmoji += "\xf0\x9f\x98\x80"; // 😀
+
+    store.store(packLevelKey(1, false), {"Zoink", "https://youtu.be/x", false, NOW});
+    store.store(packLevelKey(1, true), {"Zoink & Trick", "", false, NOW});
+    store.store(packLevelKey(2, false), {longAscii, "", false, NOW});
+    store.store(packLevelKey(3, false), {longAccented, "", true, NOW});
+    store.store(packLevelKey(4, false), {longEmoji, "", false, NOW});
+    // Past CACHE_EXPIRY, so only the changelog keeps it.
+    long long old = NOW - CACHE_EXPIRY - 600;
+    store.store(packLevelKey(5, false), {"Zoink", "", false, old});
+
+    VerifierLabel text;
+    expect(hit(store, packLevelKey(1, false), false, text) == 0, "a hit doesn't allocate");
+    expect(std::string_view(text.data()) == "Verified by: Zoink", "the label reads \"Verified by: <name>\"");
+    expect(hit(store, packLevelKey(1, false), true, text) == 0, "a solo hit on a 2P level doesn't allocate");
+    expect(std::string_view(text.data()) == "[Solo] Verified by: Zoink", "a solo entry on a 2P level says so");
+    expect(hit(store, packLevelKey(1, true), true, text) == 0, "a 2P hit doesn't allocate");
+    expect(std::string_view(text.data()) == "[2P] Zoink & Trick", "a 2P entry gets the short prefix");
+
+    expect(hit(store, packLevelKey(2, false), false, text) == 0, "a long name doesn't allocate");
+    expect(std::strlen(text.data()) == VERIFIER_LABEL_MAX - 1, "a long name fills the buffer");
+    for (int id : {3, 4}) {
+        for (bool twoPlayer : {false, true}) {
+            expect(hit(store, packLevelKey(id, false), twoPlayer, text) == 0, "a long multibyte name doesn't allocate");
+            expect(endsOnCodePoint(text.data()), "a long multibyte name is cut between code points");
+        }
+    }
+
+    auto oldKey = packLevelKey(5, false);
+    expect(hit(store, oldKey, false, text) == SIZE_MAX, "an old entry expires without the changelog");
+    s_trackingSince = old - 60;
+    s_lastPolls[0] = s_lastPolls[1] = NOW - CHANGELOG_POLL_INTERVAL;
+    expect(hit(store, oldKey, false, text) == 0, "a hit covered by the changelog doesn't allocate");
+    s_lastPolls[1] = NOW - CHANGELOG_TRUST_WINDOW - 1;
+    expect(hit(store, oldKey, false, text) == SIZE_MAX, "coverage needs every feed polled recently");
+    s_lastPolls[1] = NOW;
+    s_sessionOnly = true;
+    expect(hit(store, oldKey, false, text) == SIZE_MAX, "with disable-cache on, the changelog doesn't count");
+    expect(hit(store, packLevelKey(1, false), false, text) == 0, "a session hit doesn't allocate");
+
+    std::printf("%s\n", s_failed ? "FAILED" : "all passed");
+    return s_failed ? 1 : 0;
+}
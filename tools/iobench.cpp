@@ -0,0 +1,277 @@
+// Compares the AsyncIo backends against plain blocking I/O on the two write
+// patterns the mod's persistence produces:
+//
+//   shards   many small files, each replaced atomically (write + fsync +
+//            rename), like the cache, snapshot and level-set files
+//   journal  a few files taking a stream of small synced appends, like the
+//            audit log; each file's appends are issued one after another
+//
+// Every run reports wall time, throughput, how long the caller was blocked
+// in I/O calls, and per-operation latency from issue to callback. Files go
+// in a fresh subdirectory of --dir, removed on exit.
+//
+//   verifier-iobench [--dir <path>] [--files <n>] [--size <bytes>]
+//                    [--journals <n>] [--appends <n>] [--record <bytes>]
+//                    [--threads <n>]
+
+#include "core/AsyncIo.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    size_t files = 256;
+    size_t size = 16 * 1024;
+    size_t journals = 4;
+    size_t appends = 256;
+    size_t record = 256;
+    size_t threads = 4;
+};
+
+struct Report {
+    double wallMs = 0;
+    double blockedMs = 0;
+    size_t bytes = 0;
+    size_t failures = 0;
+    std::vector<double> latenciesUs;
+};
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    auto at = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(at), values.end());
+    return values[at];
+}
+
+static void print(char const* workload, char const* backend, Report& r) {
+    auto p50 = percentile(r.latenciesUs, 0.5);
+    auto p99 = percentile(r.latenciesUs, 0.99);
+    std::printf(
+        "  %-8s %-9s %9.1f ms  %8.1f MB/s  caller blocked %9.1f ms  p50 %9.1f us  p99 %9.1f us%s\n", workload,
+        backend, r.wallMs, r.bytes / 1e6 / (r.wallMs / 1e3), r.blockedMs, p50, p99, r.failures ? "  (FAILURES)" : ""
+    );
+}
+
+static std::vector<uint8_t> payload(size_t size, size_t seed) {
+    std::vector<uint8_t> out(size);
+    for (size_t i = 0; i < size; ++i) out[i] = static_cast<uint8_t>((i * 131 + seed) & 0xff);
+    return out;
+}
+
+static std::filesystem::path shardPath(Config const& cfg, size_t i) {
+    return cfg.dir / ("shard" + std::to_string(i) + ".bin");
+}
+
+static std::filesystem::path journalPath(Config const& cfg, size_t i) {
+    return cfg.dir / ("journal" + std::to_string(i) + ".log");
+}
+
+// cfg.dir is the subdirectory main() made for this run.
+static void reset(Config const& cfg) {
+    std::filesystem::remove_all(cfg.dir);
+    std::filesystem::create_directories(cfg.dir);
+}
+
+static Report shardsBlocking(Config const& cfg) {
+    Report r;
+    auto start = Clock::now();
+    for (size_t i = 0; i < cfg.files; ++i) {
+        auto data = payload(cfg.size, i);
+        auto opStart = Clock::now();
+        auto path = shardPath(cfg, i);
+        auto temp = path;
+        temp += ".tmp";
+        bool ok = blockingWrite(temp, data, WriteMode::Truncate, true).ok && blockingRename(temp, path).ok;
+        r.latenciesUs.push_back(msSince(opStart) * 1e3);
+        r.failures += !ok;
+        r.bytes += data.size();
+    }
+    r.wallMs = r.blockedMs = msSince(start);
+    return r;
+}
+
+static Report shardsAsync(Config const& cfg, AsyncIo& io) {
+    Report r;
+    auto start = Clock::now();
+    for (size_t i = 0; i < cfg.files; ++i) {
+        auto data = payload(cfg.size, i);
+        r.bytes += data.size();
+        auto opStart = Clock::now();
+        io.replace(shardPath(cfg, i), std::move(data), [&r, opStart](IoResult res) {
+            r.latenciesUs.push_back(msSince(opStart) * 1e3);
+            r.failures += !res.ok;
+        });
+    }
+    auto blockStart = Clock::now();
+    io.submit();
+    r.blockedMs = msSince(blockStart);
+    // Everything left is the caller waiting on purpose, not being blocked.
+    io.drain();
+    r.wallMs = msSince(start);
+    return r;
+}
+
+static Report journalBlocking(Config const& cfg) {
+    Report r;
+    auto start = Clock::now();
+    // Round-robin over the journals, as interleaved writers would.
+    for (size_t n = 0; n < cfg.appends; ++n) {
+        for (size_t j = 0; j < cfg.journals; ++j) {
+            auto record = payload(cfg.record, n * cfg.journals + j);
+            auto opStart = Clock::now();
+            r.failures += !blockingWrite(journalPath(cfg, j), record, WriteMode::Append, true).ok;
+            r.latenciesUs.push_back(msSince(opStart) * 1e3);
+            r.bytes += record.size();
+        }
+    }
+    r.wallMs = r.blockedMs = msSince(start);
+    return r;
+}
+
+// Each journal issues its next append from the previous one's callback, so
+// appends to one file stay ordered while different files overlap.
+struct JournalWriter {
+    Config const* cfg;
+    AsyncIo* io;
+    Report* report;
+    size_t index;
+    size_t written = 0;
+
+    void next() {
+        if (written == cfg->appends) return;
+        auto record = payload(cfg->record, written * cfg->journals + index);
+        report->bytes += record.size();
+        auto opStart = Clock::now();
+        io->write(journalPath(*cfg, index), std::move(record), WriteMode::Append, true, [this, opStart](IoResult res) {
+            report->latenciesUs.push_back(msSince(opStart) * 1e3);
+            report->failures += !res.ok;
+            ++written;
+            next();
+        });
+    }
+};
+
+static Report journalAsync(Config const& cfg, AsyncIo& io) {
+    Report r;
+    std::vector<JournalWriter> writers;
+    for (size_t j = 0; j < cfg.journals; ++j) writers.push_back({&cfg, &io, &r, j});
+
+    auto start = Clock::now();
+    for (auto& writer : writers) writer.next();
+    auto blockStart = Clock::now();
+    io.submit();
+    r.blockedMs = msSince(blockStart);
+    // Later appends are issued from callbacks inside drain().
+    io.drain();
+    r.wallMs = msSince(start);
+    return r;
+}
+
+static bool verify(Config const& cfg, bool journal) {
+    if (journal) {
+        for (size_t j = 0; j < cfg.journals; ++j) {
+            auto res = blockingRead(journalPath(cfg, j));
+            if (!res.ok || res.data.size() != cfg.appends * cfg.record) return false;
+            for (size_t n = 0; n < cfg.appends; ++n) {
+                auto want = payload(cfg.record, n * cfg.journals + j);
+                if (!std::equal(want.begin(), want.end(), res.data.begin() + static_cast<std::ptrdiff_t>(n * cfg.record))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    for (size_t i = 0; i < cfg.files; ++i) {
+        auto res = blockingRead(shardPath(cfg, i));
+        if (!res.ok || res.data != payload(cfg.size, i)) return false;
+    }
+    return true;
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(
+        stderr,
+        "usage: %s [--dir <path>] [--files <n>] [--size <bytes>] [--journals <n>] [--appends <n>]\n"
+        "          [--record <bytes>] [--threads <n>]\n",
+        argv0
+    );
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    Config cfg;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string_view name = argv[i];
+        if (name == "--dir") {
+            cfg.dir = argv[i + 1];
+            continue;
+        }
+        auto value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (name == "--files") cfg.files = value;
+        else if (name == "--size") cfg.size = value;
+        else if (name == "--journals") cfg.journals = value;
+        else if (name == "--appends") cfg.appends = value;
+        else if (name == "--record") cfg.record = value;
+        else if (name == "--threads") cfg.threads = value;
+        else return usage(argv[0]);
+    }
+    if (cfg.files == 0 || cfg.journals == 0 || cfg.appends == 0 || cfg.threads == 0) return usage(argv[0]);
+
+    // Our own directory, so cleaning up can't take anything else with it.
+    auto base = cfg.dir;
+    std::filesystem::create_directories(base);
+    std::random_device seed;
+    do cfg.dir = base / ("verifier-iobench-" + std::to_string(seed()));
+    while (!std::filesystem::create_directory(cfg.dir));
+
+    std::printf(
+        "%s: shards %zu x %zu B, journal %zu x %zu x %zu B, %zu threads\n", cfg.dir.string().c_str(), cfg.files,
+        cfg.size, cfg.journals, cfg.appends, cfg.record, cfg.threads
+    );
+    if (!makeIoUringIo()) std::printf("  (io_uring unavailable, skipping it)\n");
+
+    bool allOk = true;
+    auto check = [&](bool journal) {
+        if (verify(cfg, journal)) return;
+        std::printf("  contents did not verify\n");
+        allOk = false;
+    };
+
+    for (bool journal : {false, true}) {
+        char const* workload = journal ? "journal" : "shards";
+
+        reset(cfg);
+        auto r = journal ? journalBlocking(cfg) : shardsBlocking(cfg);
+        print(workload, "blocking", r);
+        check(journal);
+
+        auto runAsync = [&](std::unique_ptr<AsyncIo> io) {
+            if (!io) return;
+            reset(cfg);
+            auto report = journal ? journalAsync(cfg, *io) : shardsAsync(cfg, *io);
+            print(workload, io->name(), report);
+            check(journal);
+        };
+        runAsync(makeThreadPoolIo(cfg.threads));
+        runAsync(makeIoUringIo());
+    }
+
+    std::filesystem::remove_all(cfg.dir);
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+// Compares the JSON backends (JsonBackend.hpp) on payloads shaped like the
+// mod's: single level responses, bulk list responses and cache files, each at
+// several sizes. Every backend's result is checked against the streaming
+// reducers.
+//
+// For each payload and backend it reports throughput, allocations per parse,
+// the peak heap one parse adds on top of what was live before it, and what
+// the backend newly keeps allocated for later parses (simdjson grows its
+// parser's buffers to the largest document so far).
+// Operator new is replaced with a counting one to get these.
+//
+// The simdjson column is there when CMake finds simdjson. matjson needs the
+// Geode SDK and isn't built here.
+//
+//   verifier-jsonbench [--min-ms <n>]
+
+#include "core/CacheFile.hpp"
+#include "core/LevelKey.hpp"
+#include "core/ResponseReducer.hpp"
+#include "core/SimdjsonReducer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+static size_t s_allocations = 0;
+static size_t s_live = 0;
+static size_t s_peak = 0;
+
+// Each block starts with its size, so delete can take it off s_live.
+static constexpr size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(std::size_t size) {
+    auto p = static_cast<char*>(std::malloc(size + HEADER));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(p) = size;
+    ++s_allocations;
+    s_live += size;
+    s_peak = std::max(s_peak, s_live);
+    return p + HEADER;
+}
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (std::bad_alloc const&) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+    return operator new(size, std::nothrow);
+}
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    auto block = static_cast<char*>(p) - HEADER;
+    s_live -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+void operator delete(void* p, std::nothrow_t const&) noexcept {
+    operator delete(p);
+}
+void operator delete[](void* p, std::nothrow_t const&) noexcept {
+    operator delete(p);
+}
+
+using Clock = std::chrono::steady_clock;
+using CacheRows = std::vector<std::pair<std::string, VerifierData>>;
+
+// One backend's three entry points, as in JsonBackend.hpp.
+struct Backend {
+    char const* name;
+    std::optional<LevelSummary> (*level)(std::string_view);
+    std::optional<std::vector<SnapshotEntry>> (*list)(std::string_view);
+    bool (*cache)(std::string_view, std::function<void(std::string_view, VerifierData)> const&);
+};
+
+static std::vector<Backend> backends() {
+    std::vector<Backend> all{{"streaming", reduceLevelResponse, reduceListResponse, reduceCacheFile}};
+#ifdef VERIFIER_HAVE_SIMDJSON
+    all.push_back({"simdjson", simdjsonLevelResponse, simdjsonListResponse, simdjsonCacheFile});
+#endif
+    return all;
+}
+
+// An AREDL user object; only the names are read.
+static std::string user(size_t i) {
+    return R"({"id":"0b1c2d3e-)" + std::to_string(100000 + i) + R"(","username":"player)" + std::to_string(i) +
+        R"(","global_name":)" + (i % 4 ? R"("Player é)" + std::to_string(i) + '"' : std::string("null")) +
+        R"(,"avatar_url":null,"discord_id":null,"country":)" + std::to_string(i % 250) + "}";
+}
+
+// A level response: the fields the mod reads among the ones it doesn't, and
+// a records array the reducers have to skip.
+static std::string levelResponse(size_t verifications, size_t records) {
+    std::string out = R"({"id":"6f1a2b3c-4d5e-6f70-8192-a3b4c5d6e7f8","position":12,"name":"Tidal Wave",)"
+                      R"("points":3612,"legacy":false,"level_id":86407629,"two_player":false,)"
+                      R"("tags":["Wave","Memory","Overall"],"description":"An extreme demon \"classic\".",)"
+                      R"("song":null,"edel_enjoyment":null,"is_edel_pending":false,"gddl_tier":35.2,"nlw_tier":null,)"
+                      R"("publisher":)" + user(1) + R"(,"verifications":[)";
+    for (size_t i = 0; i < verifications; ++i) {
+        if (i) out += ',';
+        out += R"({"id":"v)" + std::to_string(i) + R"(","video_url":"https://youtu.be/9fsZ014qB3s",)"
+               R"("hide_video":false,"mobile":false,"created_at":"2023-12-17T00:00:00Z","submitted_by":)" +
+            user(i) + "}";
+    }
+    out += R"(],"creators":[)";
+    for (size_t i = 0; i < 3; ++i) {
+        if (i) out += ',';
+        out += user(i + 10);
+    }
+    out += R"(],"records":[)";
+    for (size_t i = 0; i < records; ++i) {
+        if (i) out += ',';
+        out += R"({"id":"r)" + std::to_string(i) + R"(","mobile":)" + (i % 5 ? "false" : "true") +
+            R"(,"video_url":"https://youtu.be/abc)" + std::to_string(i) +
+            R"(","created_at":"2024-02-01T12:00:00Z","submitted_by":)" + user(i) + "}";
+    }
+    out += "]}";
+    return out;
+}
+
+// A bulk list response of `count` levels.
+static std::string listResponse(size_t count) {
+    std::string out = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) out += ',';
+        out += R"({"id":"6f1a2b3c-)" + std::to_string(i) + R"(","position":)" + std::to_string(i + 1) +
+            R"(,"name":"Level )" + std::to_string(i) + R"(","points":)" + std::to_string(5000 - i % 5000) +
+            R"(,"legacy":)" + (i % 9 ? "false" : "true") + R"(,"level_id":)" + std::to_string(10'000'000 + i * 37) +
+            R"(,"two_player":)" + (i % 23 ? "false" : "true") + R"(,"tags":["Timings","Wave"],"description":null,)"
+            R"("edel_enjoyment":null,"is_edel_pending":false,"gddl_tier":null,"nlw_tier":"Extreme"})";
+    }
+    out += "]";
+    return out;
+}
+
+// A cache file of `count` entries, written by the mod's own writer.
+static std::string cacheFile(size_t count) {
+    std::string out = "{";
+    for (size_t i = 0; i < count; ++i) {
+        VerifierData data;
+        data.verifier = "Verifier " + std::to_string(i % 997) + (i % 11 ? "" : " & Duo");
+        if (i % 3) data.video = "https://youtu.be/" + std::to_string(1'000'000 + i);
+        data.legacy = i % 7 == 0;
+        data.timestamp = 1'700'000'000 + static_cast<long long>(i);
+        data.hits = static_cast<int>(i % 40);
+        data.seen = data.timestamp + 60;
+        data.platformer = i % 13 == 0;
+        writeJsonCacheEntry(out, packLevelKey(static_cast<int>(10'000'000 + i), i % 17 == 0), data, i == 0);
+    }
+    out += "}";
+    return out;
+}
+
+static bool same(LevelSummary const& a, LevelSummary const& b) {
+    return a.names == b.names && a.video == b.video && a.legacy == b.legacy;
+}
+
+static bool same(std::vector<SnapshotEntry> const& a, std::vector<SnapshotEntry> const& b) {
+    return std::ranges::equal(a, b, [](SnapshotEntry const& x, SnapshotEntry const& y) {
+        return x.key == y.key && x.record.position == y.record.position && x.record.flags == y.record.flags;
+    });
+}
+
+static bool same(CacheRows const& a, CacheRows const& b) {
+    return std::ranges::equal(a, b, [](auto const& x, auto const& y) {
+        auto const& l = x.second;
+        auto const& r = y.second;
+        return x.first == y.first && l.verifier == r.verifier && l.video == r.video && l.legacy == r.legacy &&
+            l.timestamp == r.timestamp && l.hits == r.hits && l.seen == r.seen && l.platformer == r.platformer;
+    });
+}
+
+static std::optional<CacheRows> readCache(Backend const& backend, std::string_view json) {
+    CacheRows rows;
+    bool ok = backend.cache(json, [&](std::string_view key, VerifierData data) {
+        rows.emplace_back(std::string(key), std::move(data));
+    });
+    if (!ok) return std::nullopt;
+    return rows;
+}
+
+struct Payload {
+    std::string name;
+    std::string json;
+    enum Kind { Level, List, Cache } kind;
+};
+
+// Parses once the way the mod consumes the result. False if it didn't parse.
+static bool parseOnce(Backend const& backend, Payload const& payload) {
+    switch (payload.kind) {
+        case Payload::Level:
+            return backend.level(payload.json).has_value();
+        case Payload::List:
+            return backend.list(payload.json).has_value();
+        case Payload::Cache: {
+            size_t entries = 0;
+            bool ok = backend.cache(payload.json, [&](std::string_view key, VerifierData) {
+                if (parseLevelKey(key)) ++entries;
+            });
+            return ok && entries > 0;
+        }
+    }
+    return false;
+}
+
+// Same result as the streaming reducers.
+static bool matches(Backend const& backend, Backend const& reference, Payload const& payload) {
+    switch (payload.kind) {
+        case Payload::Level: {
+            auto a = backend.level(payload.json), b = reference.level(payload.json);
+            return a && b && same(*a, *b);
+        }
+        case Payload::List: {
+            auto a = backend.list(payload.json), b = reference.list(payload.json);
+            return a && b && same(*a, *b);
+        }
+        case Payload::Cache: {
+            auto a = readCache(backend, payload.json), b = readCache(reference, payload.json);
+            return a && b && same(*a, *b);
+        }
+    }
+    return false;
+}
+
+static bool run(Backend const& backend, Payload const& payload, double minMs) {
+    // Allocated before the first parse and still there after the last: the
+    // backend's own buffers.
+    auto liveBefore = s_live;
+    if (!parseOnce(backend, payload)) {
+        std::printf("  %-10s parse FAILED\n", backend.name);
+        return false;
+    }
+
+    auto allocationsBefore = s_allocations;
+    auto baseline = s_live;
+    s_peak = s_live;
+    parseOnce(backend, payload);
+    auto allocations = s_allocations - allocationsBefore;
+    auto peak = s_peak - baseline;
+
+    size_t parses = 0;
+    auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    while (parses < 5 || elapsed.count() < minMs) {
+        parseOnce(backend, payload);
+        ++parses;
+        elapsed = Clock::now() - start;
+    }
+    auto perParse = elapsed.count() / static_cast<double>(parses);
+
+    std::printf(
+        "  %-10s %8.1f MB/s  %9.1f us/parse  %7zu allocs  peak %9zu B  kept %8zu B\n", backend.name,
+        static_cast<double>(payload.json.size()) / perParse / 1000.0, perParse * 1000.0, allocations, peak,
+        s_live - liveBefore
+    );
+    return true;
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(stderr, "usage: %s [--min-ms <n>]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    double minMs = 200;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string_view name = argv[i];
+        if (name == "--min-ms") minMs = std::strtod(argv[i + 1], nullptr);
+        else return usage(argv[0]);
+    }
+
+    std::vector<Payload> payloads{
+        {"level, 1 verification", levelResponse(1, 0), Payload::Level},
+        {"level, duo", levelResponse(2, 0), Payload::Level},
+        {"level, 500 records", levelResponse(1, 500), Payload::Level},
+        {"list, 100 levels", listResponse(100), Payload::List},
+        {"list, 1000 levels", listResponse(1000), Payload::List},
+        {"list, 5000 levels", listResponse(5000), Payload::List},
+        {"cache, 1k entries", cacheFile(1000), Payload::Cache},
+        {"cache, 10k entries", cacheFile(10000), Payload::Cache},
+        {"cache, 50k entries", cacheFile(50000), Payload::Cache},
+    };
+
+    auto all = backends();
+    int failed = 0;
+    for (auto const& payload : payloads) {
+        std::printf("%s (%zu bytes)\n", payload.name.c_str(), payload.json.size());
+        for (auto const& backend : all) {
+            // Timed first, so "kept" sees the backend's first parse of this
+            // payload.
+            if (!run(backend, payload, minMs)) ++failed;
+            else if (&backend != &all.front() && !matches(backend, all.front(), payload)) {
+                std::printf("  %-10s MISMATCH with %s\n", backend.name, all.front().name);
+                ++failed;
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,321 @@
+// Simulates the mod's lifecycle handling on a desktop. Its in-memory tiers
+// run a steady workload (the level cache, a texture cache, async file saves),
+// and lifecycle events arrive as POSIX signals:
+//
+//   SIGUSR1  entered background     SIGCONT  back in the foreground
+//   SIGUSR2  low memory warning     SIGINT   stop
+//
+// so `kill -USR1 <pid>` plays the part of the OS. --script runs a fixed
+// sequence instead, one event per --interval milliseconds. After each event
+// it prints per-handler timings and the footprint of every tier, and after
+// returning to work, how long the first lookup took to rehydrate.
+//
+// The level cache is the mod's own StagedCache, loaded, saved and dehydrated
+// the way VerifierCache.cpp does it. The texture cache and the other file
+// saves are stand-ins of the same shape. Files go in a fresh subdirectory of
+// --dir, removed on exit.
+//
+//   verifier-lifecyclesim [--dir <path>] [--entries <n>] [--budget <ms>]
+//                         [--script bg,fg,low,...] [--interval <ms>]
+
+#include "core/AsyncIo.hpp"
+#include "core/CacheFile.hpp"
+#include "core/LevelKey.hpp"
+#include "core/Lifecycle.hpp"
+#include "core/ResponseReducer.hpp"
+#include "core/StagedCache.hpp"
+#include "core/TtlCache.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t TEXTURE_BYTES = 192 * 108 * 4;
+static constexpr size_t TEXTURE_MAX = 32;
+static constexpr auto TICK = std::chrono::milliseconds(10);
+// As in VerifierCache.cpp.
+static constexpr size_t HOT_ENTRIES = 256;
+static constexpr size_t TAIL_SLICE = 2048;
+
+struct JsonCodec {
+    template <class Out>
+    static void writeBegin(Out& out) {
+        out += '{';
+    }
+    template <class Out>
+    static void writeEntry(Out& out, uint32_t key, VerifierData const& data, bool first) {
+        writeJsonCacheEntry(out, key, data, first);
+    }
+    template <class Out>
+    static void writeEnd(Out& out) {
+        out += '}';
+    }
+    template <class F>
+    static bool read(std::string_view text, F&& onEntry) {
+        return reduceCacheFile(text, [&](std::string_view k, VerifierData data) {
+            if (auto key = parseLevelKey(k)) onEntry(*key, std::move(data));
+        });
+    }
+};
+
+using LevelCache = ttl::TtlCache<
+    uint32_t, VerifierData, JsonCodec, ttl::NoEviction<uint32_t>, ttl::NeverExpire, ttl::FilePersistence
+>;
+using TextureCache = ttl::TtlCache<
+    uint32_t, std::vector<uint8_t>, ttl::NoCodec, ttl::LruEviction<uint32_t>, ttl::NeverExpire, ttl::NoPersistence
+>;
+
+static volatile std::sig_atomic_t s_signal = 0;
+
+static void onSignal(int sig) {
+    s_signal = sig;
+}
+
+static long long nowSec() {
+    return static_cast<long long>(std::time(nullptr));
+}
+
+// The mod's tiers, with the level cache hydrated lazily and its tail read a
+// slice per tick, as in VerifierCache.cpp.
+struct Tiers {
+    StagedCache<LevelCache> levels;
+    TextureCache textures{ttl::LruEviction<uint32_t>(TEXTURE_MAX)};
+    std::unique_ptr<AsyncIo> io;
+    size_t saves = 0;
+    std::optional<double> hydrateMs;
+    double tailMs = 0;
+
+    // Null while the tail that may hold `key` is still unread.
+    VerifierData const* find(uint32_t key, bool& pending) {
+        if (levels.dehydrated()) {
+            auto start = Clock::now();
+            levels.open();
+            levels.readTail(HOT_ENTRIES);
+            hydrateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            tailMs = 0;
+        }
+        auto data = levels.cache().findAnyAge(key);
+        pending = !data && levels.loading();
+        if (data) levels.recordAccess(key, nowSec());
+        return data;
+    }
+
+    // Returns true the tick the tail finishes.
+    bool readTail() {
+        if (!levels.loading()) return false;
+        auto start = Clock::now();
+        levels.readTail(TAIL_SLICE);
+        tailMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return !levels.loading();
+    }
+
+    size_t footprint() const {
+        // Rough: entries with their strings, plus texture pixels.
+        size_t bytes = levels.cache().size() * (sizeof(uint32_t) + sizeof(VerifierData) + 48);
+        bytes += textures.size() * TEXTURE_BYTES;
+        return bytes;
+    }
+};
+
+static VerifierData makeData(uint32_t key) {
+    VerifierData data;
+    data.verifier = "Verifier" + std::to_string(levelIDFromKey(key) % 997);
+    if (key % 3 == 0) data.video = "https://youtu.be/" + std::to_string(key);
+    data.timestamp = 1'700'000'000 + key;
+    return data;
+}
+
+static size_t residentBytes() {
+#if defined(__linux__)
+    if (auto* f = std::fopen("/proc/self/statm", "r")) {
+        unsigned long size = 0, resident = 0;
+        int n = std::fscanf(f, "%lu %lu", &size, &resident);
+        std::fclose(f);
+        if (n == 2) return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+static void registerHandlers(Tiers& tiers) {
+    using enum LifecycleEvent;
+    using enum LifecyclePhase;
+
+    addLifecycleHandler(Persist, "level cache", [&](LifecycleEvent event, LifecycleDeadline) {
+        if (event != Background || tiers.levels.dehydrated() || !tiers.levels.dirty()) return;
+        if (!tiers.levels.save(nowSec())) std::printf("    level cache save failed\n");
+    });
+    addLifecycleHandler(Flush, "file saves", [&](LifecycleEvent event, LifecycleDeadline deadline) {
+        if (event == Foreground) return;
+        if (!tiers.io->drainUntil(deadline)) std::printf("    file saves still pending at the deadline\n");
+    });
+    addLifecycleHandler(Trim, "textures", [&](LifecycleEvent event, LifecycleDeadline) {
+        if (event != Foreground) tiers.textures.clear();
+    });
+    addLifecycleHandler(Trim, "level cache", [&](LifecycleEvent event, LifecycleDeadline deadline) {
+        if (event != LowMemory || tiers.levels.loading()) return;
+        if (!tiers.levels.dehydrate(nowSec(), deadline)) std::printf("    level cache kept: no time to save it\n");
+    });
+}
+
+static void handle(Tiers& tiers, LifecycleEvent event, std::chrono::milliseconds budget) {
+    auto footprint = tiers.footprint();
+    auto rss = residentBytes();
+    auto report = dispatchLifecycle(event, budget);
+    std::printf(
+        "%s: %.2f ms%s\n", lifecycleEventName(event), report.seconds * 1000, report.overran ? " (OVER BUDGET)" : ""
+    );
+    for (auto const& step : report.steps) std::printf("    %-12s %8.2f ms\n", step.name, step.seconds * 1000);
+    std::printf(
+        "    tiers %zu -> %zu KiB, rss %zu -> %zu KiB, %zu level entries, %zu textures\n", footprint / 1024,
+        tiers.footprint() / 1024, rss / 1024, residentBytes() / 1024, tiers.levels.cache().size(), tiers.textures.size()
+    );
+    tiers.hydrateMs.reset();
+}
+
+static std::optional<LifecycleEvent> parseEvent(std::string_view name) {
+    if (name == "bg") return LifecycleEvent::Background;
+    if (name == "fg") return LifecycleEvent::Foreground;
+    if (name == "low") return LifecycleEvent::LowMemory;
+    return std::nullopt;
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(
+        stderr,
+        "usage: %s [--dir <path>] [--entries <n>] [--budget <ms>] [--script bg,fg,low,...] [--interval <ms>]\n",
+        argv0
+    );
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::filesystem::path base = std::filesystem::temp_directory_path();
+    size_t entries = 50000;
+    std::chrono::milliseconds budget{1000}, interval{500};
+    std::vector<LifecycleEvent> script;
+    bool scripted = false;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string_view name = argv[i];
+        std::string_view value = argv[i + 1];
+        if (name == "--dir") base = argv[i + 1];
+        else if (name == "--entries") entries = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (name == "--budget") budget = std::chrono::milliseconds(std::strtoll(argv[i + 1], nullptr, 10));
+        else if (name == "--interval") interval = std::chrono::milliseconds(std::strtoll(argv[i + 1], nullptr, 10));
+        else if (name == "--script") {
+            scripted = true;
+            while (!value.empty()) {
+                auto comma = value.find(',');
+                auto event = parseEvent(value.substr(0, comma));
+                if (!event) return usage(argv[0]);
+                script.push_back(*event);
+                value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+            }
+        }
+        else return usage(argv[0]);
+    }
+    if (entries == 0) return usage(argv[0]);
+
+    // Our own directory, so cleaning up can't take anything else with it.
+    std::filesystem::create_directories(base);
+    std::filesystem::path dir;
+    std::random_device seed;
+    do dir = base / ("verifier-lifecyclesim-" + std::to_string(seed()));
+    while (!std::filesystem::create_directory(dir));
+
+    Tiers tiers;
+    tiers.levels.cache().persistence().setPath(dir / "verifier_cache.json");
+    tiers.io = makeIoUringIo();
+    if (!tiers.io) tiers.io = makeThreadPoolIo(1);
+    registerHandlers(tiers);
+
+    std::vector<uint32_t> keys;
+    for (size_t i = 0; i < entries; ++i) keys.push_back(packLevelKey(static_cast<int>(1000 + i / 2), i % 2));
+    for (auto key : keys) tiers.levels.store(key, makeData(key));
+    tiers.levels.save(nowSec());
+
+    std::signal(SIGUSR1, onSignal);
+    std::signal(SIGUSR2, onSignal);
+    std::signal(SIGCONT, onSignal);
+    std::signal(SIGINT, onSignal);
+    std::printf(
+        "%zu entries, %s I/O, %lld ms budget%s\n", entries, tiers.io->name(), static_cast<long long>(budget.count()),
+        scripted ? "" : "; waiting for signals (USR1 background, CONT foreground, USR2 low memory, INT stop)"
+    );
+#if defined(__linux__)
+    if (!scripted) std::printf("pid %d\n", static_cast<int>(getpid()));
+#endif
+
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+    size_t nextScripted = 0;
+    auto nextEventAt = Clock::now() + interval;
+    bool background = false;
+
+    while (true) {
+        std::optional<LifecycleEvent> event;
+        if (scripted && Clock::now() >= nextEventAt) {
+            if (nextScripted == script.size()) break;
+            event = script[nextScripted++];
+            nextEventAt = Clock::now() + interval;
+        }
+        else if (int sig = s_signal) {
+            s_signal = 0;
+            if (sig == SIGINT) break;
+            event = sig == SIGUSR1 ? LifecycleEvent::Background
+                : sig == SIGUSR2 ? LifecycleEvent::LowMemory
+                : LifecycleEvent::Foreground;
+        }
+        if (event) {
+            handle(tiers, *event, budget);
+            background = *event == LifecycleEvent::Background;
+        }
+
+        // A backgrounded game does no work.
+        if (!background) {
+            for (int i = 0; i < 8; ++i) {
+                auto key = keys[pick(rng)];
+                bool pending = false;
+                if (!tiers.find(key, pending) && !pending) tiers.levels.store(key, makeData(key));
+                if (i == 0 && !tiers.textures.find(key, 0)) tiers.textures.store(key, std::vector<uint8_t>(TEXTURE_BYTES, 1));
+            }
+            if (tiers.hydrateMs) {
+                std::printf(
+                    "    first lookup rehydrated %zu entries in %.2f ms\n", tiers.levels.cache().size(), *tiers.hydrateMs
+                );
+                tiers.hydrateMs.reset();
+            }
+            if (tiers.readTail()) {
+                std::printf("    rest of the cache file, %zu entries, read in %.2f ms\n", tiers.levels.cache().size(), tiers.tailMs);
+            }
+            // A periodic save, like metrics.prom.
+            if (++tiers.saves % 50 == 0) {
+                std::string text = "saves " + std::to_string(tiers.saves) + "\n";
+                tiers.io->replace(dir / "metrics.prom", std::vector<uint8_t>(text.begin(), text.end()), {});
+            }
+            tiers.io->poll();
+        }
+        std::this_thread::sleep_for(TICK);
+    }
+
+    tiers.io->drain();
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,283 @@
+// Compares the codecs generated from Schema<VerifierData> with the same codecs
+// written out field by field, on a set of cache records:
+//
+//   json encode    writeJsonCacheEntry() against a writer naming each field
+//   json decode    readJsonRecord() against a JsonReader loop comparing keys
+//   document       the mod's matjson path: schemaFromJson()'s single pass
+//                  over the members against the old contains() + operator[]
+//                  per field. matjson needs the Geode SDK, so simdjson's DOM
+//                  stands in for it; only there when CMake finds simdjson.
+//   binary         binary::encode()/decode(), which had no hand-written
+//                  version to compare with
+//
+// Every decoder's output is checked against the records it was given.
+//
+//   verifier-schemabench [--records <n>] [--min-ms <n>]
+
+#include "core/BinaryCodec.hpp"
+#include "core/CacheFile.hpp"
+#include "core/JsonReader.hpp"
+#include "core/LevelKey.hpp"
+#include "core/VerifierData.hpp"
+
+#ifdef VERIFIER_HAVE_SIMDJSON
+#include <simdjson.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<VerifierData> makeRecords(size_t count) {
+    std::vector<VerifierData> records(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& data = records[i];
+        data.verifier = "Verifier " + std::to_string(i % 997) + (i % 11 ? "" : " & Duo");
+        if (i % 3) data.video = "https://youtu.be/" + std::to_string(1'000'000 + i);
+        data.legacy = i % 7 == 0;
+        data.timestamp = 1'700'000'000 + static_cast<long long>(i);
+        data.hits = static_cast<int>(i % 40);
+        data.seen = data.timestamp + 60;
+        data.platformer = i % 13 == 0;
+    }
+    return records;
+}
+
+static bool same(VerifierData const& a, VerifierData const& b) {
+    return a.verifier == b.verifier && a.video == b.video && a.legacy == b.legacy && a.timestamp == b.timestamp &&
+        a.hits == b.hits && a.seen == b.seen && a.platformer == b.platformer;
+}
+
+static bool same(std::vector<VerifierData> const& a, std::vector<VerifierData> const& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!same(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+static int s_failed = 0;
+
+// Runs `pass` over every record until --min-ms has gone by, then `check`s
+// what the last pass produced.
+template <class F, class Check>
+static void run(char const* label, size_t records, double minMs, F&& pass, Check&& check) {
+    size_t passes = 0;
+    auto start = Clock::now();
+    std::chrono::duration<double, std::nano> elapsed{};
+    while (passes < 3 || elapsed.count() < minMs * 1e6) {
+        pass();
+        ++passes;
+        elapsed = Clock::now() - start;
+    }
+    bool ok = check();
+    std::printf(
+        "  %-34s %8.1f ns/record%s\n", label, elapsed.count() / static_cast<double>(passes * records),
+        ok ? "" : "  MISMATCH"
+    );
+    if (!ok) ++s_failed;
+}
+
+// The JSON record, one field at a time.
+static void writeByHand(std::string& out, VerifierData const& data) {
+    out += std::string_view(R"({"verifier":)");
+    writeJsonValue(out, data.verifier);
+    out += std::string_view(R"(,"video":)");
+    writeJsonValue(out, data.video);
+    out += std::string_view(R"(,"legacy":)");
+    writeJsonValue(out, data.legacy);
+    out += std::string_view(R"(,"timestamp":)");
+    writeJsonValue(out, data.timestamp);
+    out += std::string_view(R"(,"hits":)");
+    writeJsonValue(out, data.hits);
+    out += std::string_view(R"(,"seen":)");
+    writeJsonValue(out, data.seen);
+    out += std::string_view(R"(,"platformer":)");
+    writeJsonValue(out, data.platformer);
+    out += '}';
+}
+
+template <class T>
+static bool readOrSkip(JsonReader& reader, T& out) {
+    return readJsonField(reader, out) || reader.skip();
+}
+
+static bool readByHand(JsonReader& reader, VerifierData& data) {
+    return reader.readObject([&](std::string_view key) {
+        if (key == "verifier") return readOrSkip(reader, data.verifier);
+        if (key == "video") return readOrSkip(reader, data.video);
+        if (key == "legacy") return readOrSkip(reader, data.legacy);
+        if (key == "timestamp") return readOrSkip(reader, data.timestamp);
+        if (key == "hits") return readOrSkip(reader, data.hits);
+        if (key == "seen") return readOrSkip(reader, data.seen);
+        if (key == "platformer") return readOrSkip(reader, data.platformer);
+        return reader.skip();
+    });
+}
+
+// Reads the records of a cache file with `readRecord`.
+template <class F>
+static std::vector<VerifierData> readAll(std::string_view text, F&& readRecord) {
+    std::vector<VerifierData> out;
+    JsonReader reader(text);
+    bool ok = reader.readObject([&](std::string_view) {
+        VerifierData data;
+        if (!readRecord(reader, data)) return false;
+        out.push_back(std::move(data));
+        return true;
+    });
+    if (!ok) out.clear();
+    return out;
+}
+
+#ifdef VERIFIER_HAVE_SIMDJSON
+namespace dom = simdjson::dom;
+
+static void readDomValue(dom::element value, std::string& out) {
+    std::string_view text;
+    out = value.get_string().get(text) ? std::string() : std::string(text);
+}
+
+static void readDomValue(dom::element value, bool& out) {
+    if (value.get_bool().get(out)) out = false;
+}
+
+template <std::signed_integral T>
+static void readDomValue(dom::element value, T& out) {
+    int64_t number;
+    out = value.get_int64().get(number) ? 0 : static_cast<T>(number);
+}
+
+// What schemaFromJson() does: one pass over the members.
+static VerifierData readDomSchema(dom::object object) {
+    VerifierData data{};
+    for (auto [key, value] : object) {
+        visitField<VerifierData>(key, [&](auto const& f) { readDomValue(value, data.*f.member); });
+    }
+    return data;
+}
+
+// What the hand-written matjson::Serialize did: contains(), then a second
+// lookup by name, per field.
+static VerifierData readDomByHand(dom::object object) {
+    VerifierData data{};
+    auto read = [&](std::string_view name, auto& out) {
+        if (object[name].error()) return;
+        readDomValue(object[name].value_unsafe(), out);
+    };
+    read("verifier", data.verifier);
+    read("video", data.video);
+    read("legacy", data.legacy);
+    read("timestamp", data.timestamp);
+    read("hits", data.hits);
+    read("seen", data.seen);
+    read("platformer", data.platformer);
+    return data;
+}
+#endif
+
+static int usage(char const* argv0) {
+    std::fprintf(stderr, "usage: %s [--records <n>] [--min-ms <n>]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    size_t count = 10000;
+    double minMs = 200;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string_view name = argv[i];
+        if (name == "--records") count = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (name == "--min-ms") minMs = std::strtod(argv[i + 1], nullptr);
+        else return usage(argv[0]);
+    }
+    if (count == 0) return usage(argv[0]);
+
+    auto records = makeRecords(count);
+    std::string out;
+
+    // The same cache file from both writers.
+    auto writeAll = [&](auto&& writeEntry) {
+        out.clear();
+        out += '{';
+        for (size_t i = 0; i < records.size(); ++i) {
+            writeEntry(packLevelKey(static_cast<int>(10'000'000 + i), false), records[i], i == 0);
+        }
+        out += '}';
+    };
+    auto writeSchema = [&](uint32_t key, VerifierData const& data, bool first) {
+        writeJsonCacheEntry(out, key, data, first);
+    };
+    auto writeHand = [&](uint32_t key, VerifierData const& data, bool first) {
+        writeJsonCacheKey(out, key, first);
+        writeByHand(out, data);
+    };
+
+    writeAll(writeHand);
+    auto handText = out;
+    writeAll(writeSchema);
+    auto text = out;
+    std::printf("%zu records, %zu bytes of JSON\n", count, text.size());
+
+    auto bench = [&](char const* label, auto&& pass, auto&& check) { run(label, count, minMs, pass, check); };
+    std::vector<VerifierData> decoded;
+    auto decodedAll = [&] { return same(decoded, records); };
+
+    std::printf("json encode\n");
+    bench("schema", [&] { writeAll(writeSchema); }, [&] { return out == text; });
+    bench("by hand", [&] { writeAll(writeHand); }, [&] { return out == text && handText == text; });
+
+    std::printf("json decode\n");
+    auto readSchema = [](JsonReader& reader, VerifierData& data) { return readJsonRecord(reader, data); };
+    bench("schema", [&] { decoded = readAll(text, readSchema); }, decodedAll);
+    bench("by hand", [&] { decoded = readAll(text, readByHand); }, decodedAll);
+
+#ifdef VERIFIER_HAVE_SIMDJSON
+    std::printf("document (simdjson DOM standing in for matjson)\n");
+    dom::parser parser;
+    dom::object file;
+    if (parser.parse(text).get_object().get(file)) {
+        std::printf("  parse FAILED\n");
+        return 1;
+    }
+    auto decodeDom = [&](auto&& readRecord) {
+        decoded.clear();
+        for (auto [key, record] : file) decoded.push_back(readRecord(record.get_object().value_unsafe()));
+    };
+    bench("schema, one pass", [&] { decodeDom(readDomSchema); }, decodedAll);
+    bench("by hand, contains() + [] per field", [&] { decodeDom(readDomByHand); }, decodedAll);
+#endif
+
+    std::printf("binary\n");
+    std::vector<uint8_t> bytes;
+    auto encodeAll = [&] {
+        bytes.clear();
+        for (auto const& data : records) binary::encode(bytes, data);
+    };
+    encodeAll();
+    auto encoded = bytes;
+    bench("encode", encodeAll, [&] { return bytes == encoded; });
+    bench(
+        "decode",
+        [&] {
+            decoded.clear();
+            std::span<uint8_t const> in(bytes);
+            while (!in.empty()) {
+                auto data = binary::decode<VerifierData>(in);
+                if (!data) break;
+                decoded.push_back(std::move(*data));
+            }
+        },
+        decodedAll
+    );
+    std::printf("  %zu bytes\n", bytes.size());
+
+    return s_failed ? 1 : 0;
+}
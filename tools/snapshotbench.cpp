@@ -0,0 +1,196 @@
+// Compares the list snapshot's Eytzinger index (SnapshotView, as the mod maps
+// it) with std::lower_bound over a sorted key array and std::unordered_map,
+// at several list sizes:
+//
+//   load     from the file's bytes to ready for lookups, and the heap that
+//            takes. The two flat layouts are used in place; the map is
+//            built from the records.
+//   warm     random lookups back to back, half of them misses
+//   cold     pages of PAGE lookups with the CPU caches flushed before each,
+//            like ListFilter checking a browser page of levels
+//
+// Operator new is replaced with a counting one for the heap figures.
+//
+//   verifier-snapshotbench [--lookups <n>]
+
+#include "core/LevelKey.hpp"
+#include "core/SnapshotFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+static size_t s_live = 0;
+
+// Each block starts with its size, so delete can take it off s_live.
+static constexpr size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(std::size_t size) {
+    auto p = static_cast<char*>(std::malloc(size + HEADER));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(p) = size;
+    s_live += size;
+    return p + HEADER;
+}
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    auto block = static_cast<char*>(p) - HEADER;
+    s_live -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Levels per browser page.
+static constexpr size_t PAGE = 10;
+// Written before each cold page: more than a phone's last-level cache, though
+// some desktop and server parts have a bigger one.
+static constexpr size_t FLUSH_BYTES = 64 << 20;
+
+// A flat snapshot searched with lower_bound: what the file would hold
+// without the Eytzinger layout.
+struct SortedSnapshot {
+    std::vector<uint32_t> keys;
+    std::vector<SnapshotRecord> records;
+
+    SnapshotRecord const* find(uint32_t key) const {
+        auto it = std::ranges::lower_bound(keys, key);
+        if (it == keys.end() || *it != key) return nullptr;
+        return &records[it - keys.begin()];
+    }
+};
+
+struct MapSnapshot {
+    std::unordered_map<uint32_t, SnapshotRecord> map;
+
+    SnapshotRecord const* find(uint32_t key) const {
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    }
+};
+
+// `count` listed levels with AREDL-like sparse IDs, a few of them 2P.
+static std::vector<SnapshotEntry> makeEntries(size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> id(1, 120'000'000);
+    std::vector<SnapshotEntry> entries;
+    entries.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        entries.push_back({packLevelKey(id(rng), i % 23 == 0), {static_cast<uint32_t>(i + 1), 0}});
+    }
+    std::ranges::sort(entries, {}, &SnapshotEntry::key);
+    auto dupes = std::ranges::unique(entries, {}, &SnapshotEntry::key);
+    entries.erase(dupes.begin(), dupes.end());
+    return entries;
+}
+
+// Half listed keys, half random ones that almost never are.
+static std::vector<uint32_t> makeLookups(std::vector<SnapshotEntry> const& entries, size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> pick(0, entries.size() - 1);
+    std::uniform_int_distribution<int> id(1, 120'000'000);
+    std::vector<uint32_t> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) keys.push_back(i % 2 ? entries[pick(rng)].key : packLevelKey(id(rng), false));
+    return keys;
+}
+
+static double nsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+template <class Index>
+static void lookups(char const* label, Index const& index, double loadNs, size_t heap,
+                    std::vector<uint32_t> const& keys, std::vector<uint8_t>& flush) {
+    size_t found = 0;
+    auto start = Clock::now();
+    for (auto key : keys) found += index.find(key) != nullptr;
+    double warm = nsSince(start) / static_cast<double>(keys.size());
+
+    // Only the page's lookups are timed, not the flush.
+    double cold = 0;
+    size_t pages = std::min<size_t>(keys.size() / PAGE, 200);
+    for (size_t p = 0; p < pages; ++p) {
+        for (size_t i = 0; i < flush.size(); i += 64) ++flush[i];
+        start = Clock::now();
+        for (size_t i = p * PAGE; i < (p + 1) * PAGE; ++i) found += index.find(keys[i]) != nullptr;
+        cold += nsSince(start);
+    }
+    cold /= static_cast<double>(pages * PAGE);
+
+    std::printf(
+        "  %-13s load %10.1f us  heap %9zu B  warm %6.1f ns/lookup  cold %6.1f ns/lookup  (%zu found)\n", label,
+        loadNs / 1000.0, heap, warm, cold, found
+    );
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(stderr, "usage: %s [--lookups <n>]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    size_t lookupCount = 2'000'000;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string_view name = argv[i];
+        if (name == "--lookups") lookupCount = std::strtoull(argv[i + 1], nullptr, 10);
+        else return usage(argv[0]);
+    }
+    if (lookupCount < PAGE) return usage(argv[0]);
+
+    std::mt19937 rng(76);
+    std::vector<uint8_t> flush(FLUSH_BYTES);
+
+    for (size_t size : {2'000, 10'000, 50'000, 100'000}) {
+        auto entries = makeEntries(size, rng);
+        auto keys = makeLookups(entries, lookupCount, rng);
+        auto file = encodeSnapshot(entries, 0);
+        std::printf("%zu levels, %zu byte snapshot\n", entries.size(), file.size());
+
+        auto before = s_live;
+        auto start = Clock::now();
+        auto view = SnapshotView::parse(file);
+        double load = nsSince(start);
+        if (!view) {
+            std::printf("  snapshot parse FAILED\n");
+            return 1;
+        }
+        lookups("eytzinger", *view, load, s_live - before, keys, flush);
+
+        // The same bytes laid out sorted are used in place too; only the
+        // copy into vectors here is a bench artifact, so it isn't counted.
+        SortedSnapshot sorted;
+        for (auto const& e : entries) {
+            sorted.keys.push_back(e.key);
+            sorted.records.push_back(e.record);
+        }
+        lookups("lower_bound", sorted, 0, 0, keys, flush);
+
+        before = s_live;
+        start = Clock::now();
+        MapSnapshot map;
+        map.map.reserve(view->size());
+        for (auto const& e : entries) map.map.emplace(e.key, e.record);
+        load = nsSince(start);
+        lookups("unordered_map", map, load, s_live - before, keys, flush);
+    }
+    return 0;
+}
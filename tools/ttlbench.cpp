@@ -0,0 +1,192 @@
+// Benchmarks TtlCache policy combinations on a synthetic workload shaped like
+// the mod's: skewed lookups over packed level keys, with a store after every
+// miss or stale hit, as resolveLevel() does.
+//
+//   verifier-ttlbench [--keys <n>] [--ops <n>] [--capacity <n>]
+
+#include "core/CacheFile.hpp"
+#include "core/LevelKey.hpp"
+#include "core/ResponseReducer.hpp"
+#include "core/TtlCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Simulated seconds per operation, so expiry kicks in during a run.
+static constexpr long long SECONDS_PER_OP = 1;
+
+struct JsonCodec {
+    template <class Out>
+    static void writeBegin(Out& out) {
+        out += '{';
+    }
+    template <class Out>
+    static void writeEntry(Out& out, uint32_t key, VerifierData const& data, bool first) {
+        writeJsonCacheEntry(out, key, data, first);
+    }
+    template <class Out>
+    static void writeEnd(Out& out) {
+        out += '}';
+    }
+    template <class F>
+    static bool read(std::string_view text, F&& onEntry) {
+        return reduceCacheFile(text, [&](std::string_view k, VerifierData data) {
+            if (auto key = parseLevelKey(k)) onEntry(*key, std::move(data));
+        });
+    }
+};
+
+struct Workload {
+    std::vector<uint32_t> keys; // one per operation
+};
+
+// Zipf-like: rank r is drawn with weight 1/(r+1), like level page views.
+static Workload makeWorkload(size_t keyCount, size_t ops) {
+    std::vector<double> weights(keyCount);
+    for (size_t i = 0; i < keyCount; ++i) weights[i] = 1.0 / static_cast<double>(i + 1);
+    std::discrete_distribution<size_t> rank(weights.begin(), weights.end());
+    std::mt19937 rng(76);
+
+    Workload w;
+    w.keys.reserve(ops);
+    for (size_t i = 0; i < ops; ++i) {
+        auto r = rank(rng);
+        w.keys.push_back(packLevelKey(static_cast<int>(50000 + r / 2), r % 2));
+    }
+    return w;
+}
+
+static VerifierData makeData(uint32_t key, long long now) {
+    VerifierData data;
+    data.verifier = "Verifier" + std::to_string(levelIDFromKey(key) % 997);
+    if (key % 3 == 0) data.video = "https://youtu.be/" + std::to_string(key);
+    data.legacy = key % 7 == 0;
+    data.timestamp = now;
+    return data;
+}
+
+template <class Cache>
+static void run(char const* label, Cache cache, Workload const& w) {
+    size_t hits = 0, stale = 0, evictions = 0;
+    long long now = 1'700'000'000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto key : w.keys) {
+        now += SECONDS_PER_OP;
+        auto status = cache.lookup(key, now).status;
+        if (status == ttl::Lookup::Hit) {
+            ++hits;
+            continue;
+        }
+        if (status == ttl::Lookup::Stale) ++stale;
+        evictions += cache.store(key, makeData(key, now));
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf(
+        "  %-28s %7.1f ns/op  hit %5.1f%%  stale %7zu  evicted %7zu  size %6zu  sizeof %3zu\n", label,
+        elapsed.count() / w.keys.size(), 100.0 * hits / w.keys.size(), stale, evictions, cache.size(), sizeof(Cache)
+    );
+}
+
+template <class Cache>
+static void runPersisted(char const* label, Cache cache, Workload const& w) {
+    long long now = 1'700'000'000;
+    for (auto key : w.keys) {
+        if (!cache.findAnyAge(key)) cache.store(key, makeData(key, now));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    cache.save();
+    std::chrono::duration<double, std::milli> saved = std::chrono::steady_clock::now() - start;
+
+    Cache loaded;
+    loaded.persistence() = cache.persistence();
+    start = std::chrono::steady_clock::now();
+    bool ok = loaded.load();
+    std::chrono::duration<double, std::milli> load = std::chrono::steady_clock::now() - start;
+
+    std::printf(
+        "  %-28s save %7.3f ms  load %7.3f ms  %zu entries, %zu bytes%s\n", label, saved.count(), load.count(),
+        cache.size(), cache.persistence().data().size(), ok ? "" : "  (load FAILED)"
+    );
+}
+
+// Turning disable-cache on: a full cache drops to `capacity` on the next
+// store. Checks that the newest entries are the ones kept.
+template <class Cache>
+static void runShrink(char const* label, Cache cache, size_t keyCount, size_t capacity) {
+    long long now = 1'700'000'000;
+    for (size_t i = 0; i < keyCount; ++i) cache.store(packLevelKey(static_cast<int>(50000 + i), false), makeData(0, now + i));
+
+    cache.eviction().setCapacity(capacity);
+    auto start = std::chrono::steady_clock::now();
+    auto evicted = cache.store(packLevelKey(1, false), makeData(0, now + keyCount));
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    long long oldestKept = std::numeric_limits<long long>::max();
+    cache.forEach([&](uint32_t, VerifierData const& data) { oldestKept = std::min(oldestKept, data.timestamp); });
+    bool newest = cache.size() == capacity && oldestKept == now + static_cast<long long>(keyCount - capacity + 1);
+    std::printf(
+        "  %-28s %9.3f ms  evicted %7zu  size %6zu%s\n", label, elapsed.count(), evicted, cache.size(),
+        newest ? "" : "  (kept the wrong entries)"
+    );
+}
+
+static int usage(char const* argv0) {
+    std::fprintf(stderr, "usage: %s [--keys <n>] [--ops <n>] [--capacity <n>]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    size_t keyCount = 20000, ops = 2'000'000, capacity = 256;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string_view name = argv[i];
+        auto value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (name == "--keys") keyCount = value;
+        else if (name == "--ops") ops = value;
+        else if (name == "--capacity") capacity = value;
+        else return usage(argv[0]);
+    }
+    if (keyCount == 0 || ops == 0 || capacity == 0) return usage(argv[0]);
+
+    auto w = makeWorkload(keyCount, ops);
+    std::printf("%zu keys, %zu ops, capacity %zu\n", keyCount, ops, capacity);
+
+    using ttl::FixedTtl;
+    using ttl::LruEviction;
+    using ttl::NeverExpire;
+    using ttl::NoCodec;
+    using ttl::NoEviction;
+    using ttl::NoPersistence;
+    using ttl::OldestEviction;
+    using ttl::TtlCache;
+    using Key = uint32_t;
+
+    run("plain map", TtlCache<Key, VerifierData, NoCodec, NoEviction<Key>, NeverExpire, NoPersistence>(), w);
+    run("ttl 1800s", TtlCache<Key, VerifierData, NoCodec, NoEviction<Key>, FixedTtl<1800>, NoPersistence>(), w);
+    run("ttl 300s + oldest-first", TtlCache<Key, VerifierData, NoCodec, OldestEviction<Key>, FixedTtl<300>, NoPersistence>(
+        OldestEviction<Key>(capacity)
+    ), w);
+    run("ttl 300s + lru", TtlCache<Key, VerifierData, NoCodec, LruEviction<Key>, FixedTtl<300>, NoPersistence>(
+        LruEviction<Key>(capacity)
+    ), w);
+    run("lru, no expiry", TtlCache<Key, VerifierData, NoCodec, LruEviction<Key>, NeverExpire, NoPersistence>(
+        LruEviction<Key>(capacity)
+    ), w);
+
+    std::printf("capacity shrink\n");
+    runShrink("oldest-first", TtlCache<Key, VerifierData, NoCodec, OldestEviction<Key>, NeverExpire, NoPersistence>(), keyCount, capacity);
+
+    std::printf("persistence\n");
+    runPersisted("json, no eviction", TtlCache<Key, VerifierData, JsonCodec, NoEviction<Key>, FixedTtl<1800>, ttl::StringPersistence>(), w);
+    return 0;
+}